@@ -24,6 +24,9 @@
  */
 
 #include "DialogAddItem.h"
+#include "ItemFilter.h"
+#include "ItemIconAtlas.h"
+#include "Localisation.h"
 #include "SLFFile.h"
 #include "STI.h"
 #include "common.h"
@@ -33,6 +36,9 @@
 #include <QListWidgetItem>
 #include <QPainter>
 #include <QPixmap>
+#include <QPixmapCache>
+
+#include <algorithm>
 
 #include "WButton.h"
 #include "WImage.h"
@@ -354,6 +360,52 @@ void DialogAddItem::mouseOverDropDownList(bool mouseover)
     }
 }
 
+// Every item of each type, sorted by name. Built from the helper's
+// per type item bitsets the first time it's needed, and only again when
+// the language changes.
+const QVector<DialogAddItem::typeEntry> &DialogAddItem::itemsOfType(item::type t)
+{
+    static QString                     s_key;
+    static QVector<QVector<typeEntry>> s_byType;
+
+    QString key = Localisation::getLocalisation()->getLanguageKey();
+
+    if (s_byType.isEmpty() || (key != s_key))
+    {
+        Localisation *loc = Localisation::getLocalisation();
+
+        s_key = key;
+        s_byType.clear();
+        s_byType.resize( static_cast<int>(item::type::Other) + 1 );
+
+        for (int k=0; k<s_byType.size(); k++)
+        {
+            QList<quint16> items = ItemFilter::ofType( static_cast<item::type>(k) ).items();
+
+            s_byType[k].reserve( items.size() );
+            for (int j=0; j<items.size(); j++)
+            {
+                typeEntry e;
+
+                e.id   = items[j];
+                e.name = loc->getItemName( items[j] );
+
+                s_byType[k] << e;
+            }
+        }
+
+        for (int k=0; k<s_byType.size(); k++)
+        {
+            std::stable_sort( s_byType[k].begin(), s_byType[k].end(), [](const typeEntry &l, const typeEntry &r)
+            {
+                return QString::localeAwareCompare( l.name, r.name ) < 0;
+            });
+        }
+    }
+
+    return s_byType[ static_cast<int>(t) ];
+}
+
 void DialogAddItem::updateList()
 {
     if (WLabel *w = qobject_cast<WLabel *>(m_widgets[ VAL_TYPE ] ))
@@ -370,20 +422,15 @@ void DialogAddItem::updateList()
     {
         items->clear();
 
-        int num_items = dbHelper::getHelper()->getNumItems();
-        for (int k=0; k<num_items; k++)
-        {
-            item   i( k );
+        const QVector<typeEntry> &entries = itemsOfType( m_type );
 
-            if (i.getType() == m_type)
-            {
-                QListWidgetItem *newItem = new QListWidgetItem( i.getName() );
-                newItem->setData( Qt::UserRole, k );
+        for (int k=0; k<entries.size(); k++)
+        {
+            QListWidgetItem *newItem = new QListWidgetItem( entries[k].name );
+            newItem->setData( Qt::UserRole, entries[k].id );
 
-                items->addItem( newItem );
-            }
+            items->addItem( newItem );
         }
-        items->sortItems(Qt::AscendingOrder);
         items->setCurrentRow(0);
     }
 }
@@ -542,20 +589,25 @@ QPixmap DialogAddItem::makeDialogForm()
 
 void DialogAddItem::makeTypePixmaps()
 {
-    // images used in the types list
+    // images used in the types list. Brightening and smooth scaling these
+    // is the slow part of building the dialog, and the result only depends
+    // on the file, brightness and size, so it's kept in the QPixmapCache.
     for (unsigned int j=0; j<sizeof(type_icons)/sizeof(type_icons[0]); j++)
     {
-        SLFFile ic( type_icons[j].filename );
+        int      height = 14 * m_scale;
+        QString  key    = QString("DialogAddItem:%1|%2:%3:%4")
+                              .arg( SLFFile::getParallelWorldPath() )
+                              .arg( type_icons[j].filename )
+                              .arg( type_icons[j].brightness )
+                              .arg( height );
 
-        if (ic.open(QFile::ReadOnly))
-        {
-            QByteArray array;
+        if (QPixmapCache::find( key, &m_typeIcon[j] ))
+            continue;
 
-            ic.readAll( array );
-            STI c( array );
-
-            QImage  im = c.getImage( 0 );
+        QImage  im = ItemIconAtlas::getAtlas()->getStiImage( type_icons[j].filename );
 
+        if (! im.isNull())
+        {
             // All item pixmaps are expected to be in ARGB32 - it'd
             // only be if a mod changed them
             //if (im.format() != QImage::Format_RGB32 )
@@ -572,9 +624,8 @@ void DialogAddItem::makeTypePixmaps()
                 data[k+1] = ((g <= 255) ? g : 255);
                 data[k+2] = ((r <= 255) ? r : 255);
             }
-            m_typeIcon[j] = QPixmap::fromImage( im.scaledToHeight( 14 * m_scale, Qt::SmoothTransformation ) );
-
-            ic.close();
+            m_typeIcon[j] = QPixmap::fromImage( im.scaledToHeight( height, Qt::SmoothTransformation ) );
+            QPixmapCache::insert( key, m_typeIcon[j] );
         }
         else
         {
@@ -31,6 +31,8 @@
 
 #include "item.h"
 
+#include <QVector>
+
 class QListWidgetItem;
 
 class DialogAddItem : public Dialog
@@ -65,6 +67,14 @@ protected:
     void mouseOverLabel(bool on) override;
 
 private:
+    struct typeEntry
+    {
+        int      id;
+        QString  name;
+    };
+
+    static const QVector<typeEntry> &itemsOfType(item::type t);
+
     QPixmap    makeDialogForm();
     QPixmap    makeWider( QImage im, int width );
     void       makeTypePixmaps();
@@ -27,6 +27,7 @@
 
 #include "DialogPreferences.h"
 #include "SLFFile.h"
+#include "Settings.h"
 #include "common.h"
 #include "main.h"
 
@@ -34,7 +35,6 @@
 #include <QFileDialog>
 #include <QPainter>
 #include <QPixmap>
-#include <QSettings>
 
 #include "WButton.h"
 #include "WCheckBox.h"
@@ -113,29 +113,23 @@ void DialogPreferences::init()
     }
     if (WLineEdit *iso = qobject_cast<WLineEdit *>(m_widgets[ VAL_ISO_LANG ] ))
     {
-        QSettings settings;
-
-        QVariant lang = settings.value( "PreferredLanguage", "ENG" );
+        QVariant lang = Settings::getSettings()->value( "PreferredLanguage", "ENG" );
 
         iso->setText( lang.toString() );
         iso->setMaxLength( 3 );
     }
     if (WLineEdit *cpage = qobject_cast<WLineEdit *>(m_widgets[ VAL_CHARSET ] ))
     {
-        QSettings settings;
-
-        QVariant charset = settings.value( "Codepage", "Windows-1251" );
+        QVariant charset = Settings::getSettings()->value( "Codepage", "Windows-1251" );
 
         cpage->setText( charset.toString() );
     }
     if (WCheckBox *cb = qobject_cast<WCheckBox *>(m_widgets[ CB_SUPPRESS_WARNINGS ] ))
     {
-        QSettings settings;
-
-        QVariant warn = settings.value( "SuppressWarningAll" );
+        Settings *settings = Settings::getSettings();
 
         cb->setTristate( false );
-        if (!warn.isNull() && (warn.toBool() == true))
+        if (settings->getBool( "SuppressWarningAll" ))
         {
             cb->setCheckState( Qt::Checked );
         }
@@ -145,9 +139,7 @@ void DialogPreferences::init()
 
             foreach ( const QString &w, individual_warnings )
             {
-                warn = settings.value( w );
-
-                if (!warn.isNull() && (warn.toBool() == true))
+                if (settings->getBool( w ))
                 {
                     // setCheckState() will set tristate implicitly if doing a partial check,
                     // but being explicit here.
@@ -178,23 +170,17 @@ void DialogPreferences::save()
 
             if (new_wizardry_path != SLFFile::getWizardryPath() )
             {
-                QSettings settings;
-
-                settings.setValue( "Wizardry Path", new_wizardry_path );
+                Settings::getSettings()->setValue( "Wizardry Path", new_wizardry_path );
             }
         }
     }
     if (WLineEdit *iso = qobject_cast<WLineEdit *>(m_widgets[ VAL_ISO_LANG ] ))
     {
-        QSettings settings;
-
-        settings.setValue( "PreferredLanguage", iso->text() );
+        Settings::getSettings()->setValue( "PreferredLanguage", iso->text() );
     }
     if (WLineEdit *cpage = qobject_cast<WLineEdit *>(m_widgets[ VAL_CHARSET ] ))
     {
-        QSettings settings;
-
-        settings.setValue( "Codepage", cpage->text() );
+        Settings::getSettings()->setValue( "Codepage", cpage->text() );
     }
 
     emit accept();
@@ -223,20 +209,20 @@ void DialogPreferences::setCb(int state)
     {
         if (m_widgets.key( cb ) == CB_SUPPRESS_WARNINGS)
         {
-            QSettings settings;
+            Settings *settings = Settings::getSettings();
 
             if (state == Qt::Checked)
             {
-                settings.setValue( "SuppressWarningAll", true );
+                settings->setValue( "SuppressWarningAll", true );
             }
             else if (state == Qt::Unchecked)
             {
-                settings.setValue( "SuppressWarningAll", false );
+                settings->setValue( "SuppressWarningAll", false );
 
                 // TODO: Have to add in every individual warning you add here also
                 foreach ( const QString &w, individual_warnings )
                 {
-                    settings.setValue( w, false );
+                    settings->setValue( w, false );
                 }
             }
         }
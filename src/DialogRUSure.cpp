@@ -26,13 +26,13 @@
 #include "DialogRUSure.h"
 
 #include "SLFFile.h"
+#include "Settings.h"
 #include "common.h"
 #include "main.h"
 
 #include <QApplication>
 #include <QPainter>
 #include <QPixmap>
-#include <QSettings>
 #include <QDebug>
 
 #include "WButton.h"
@@ -105,27 +105,21 @@ DialogRUSure::~DialogRUSure()
 
         if (hide_warning)
         {
-            QSettings settings;
-
-            settings.setValue( m_name, true );
+            Settings::getSettings()->setValue( m_name, true );
         }
     }
 }
 
 int DialogRUSure::exec()
 {
-    QSettings settings;
-
-    QVariant warn = settings.value( "SuppressWarningAll" );
+    Settings *settings = Settings::getSettings();
 
-    if (warn.isNull() || (warn.toBool() == false))
+    if (settings->getBool( "SuppressWarningAll" ) == false)
     {
         // Warnings not disabled globally but check if this warning has been individually disabled
         if (! m_name.isEmpty())
         {
-            QVariant warn = settings.value( m_name );
-
-            if (warn.isNull() || (warn.toBool() == false))
+            if (settings->getBool( m_name ) == false)
             {
                 return QDialog::exec();
             }
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2026 Anonymous Idiot
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "FactsTableModel.h"
+
+FactsTableModel::FactsTableModel(const facts &f, QObject *parent) :
+    QAbstractTableModel(parent),
+    m_facts(f)
+{
+    m_values.resize( m_facts.size() );
+
+    for (int k=0; k < m_values.size(); k++)
+    {
+        m_values.setBit( k, m_facts.getValue( k ) );
+    }
+}
+
+// Only the facts that were actually toggled get written back
+void FactsTableModel::apply(facts &f) const
+{
+    for (int k=0; k < m_values.size(); k++)
+    {
+        if (f.getValue( k ) != m_values.testBit( k ))
+        {
+            f.setValue( k, m_values.testBit( k ) );
+        }
+    }
+}
+
+int FactsTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_values.size();
+}
+
+int FactsTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : COLUMN_SIZE;
+}
+
+QVariant FactsTableModel::data(const QModelIndex &index, int role) const
+{
+    if (! index.isValid() || (index.row() >= m_values.size()))
+        return QVariant();
+
+    switch (index.column())
+    {
+        case Enabled:
+            if (role == Qt::CheckStateRole)
+                return m_values.testBit( index.row() ) ? Qt::Checked : Qt::Unchecked;
+            if (role == Qt::TextAlignmentRole)
+                return Qt::AlignCenter;
+            break;
+
+        case ID:
+            // Kept numeric, for sorting
+            if (role == Qt::DisplayRole)
+                return index.row();
+            if (role == Qt::TextAlignmentRole)
+                return (int)(Qt::AlignRight | Qt::AlignVCenter);
+            break;
+
+        case Name:
+            if (role == Qt::DisplayRole)
+                return m_facts.getKey( index.row() );
+            if (role == Qt::TextAlignmentRole)
+                return (int)(Qt::AlignLeft | Qt::AlignVCenter);
+            break;
+
+        default:
+            break;
+    }
+    return QVariant();
+}
+
+bool FactsTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (! index.isValid() || (index.row() >= m_values.size()) ||
+        (index.column() != Enabled) || (role != Qt::CheckStateRole))
+    {
+        return false;
+    }
+
+    m_values.setBit( index.row(), value.toInt() == Qt::Checked );
+
+    // Just the one cell changed
+    emit dataChanged( index, index, QVector<int>() << Qt::CheckStateRole );
+
+    return true;
+}
+
+QVariant FactsTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((orientation == Qt::Horizontal) && (role == Qt::DisplayRole))
+    {
+        switch (section)
+        {
+            case Enabled: return "Enabled";
+            case ID:      return "ID";
+            case Name:    return "Name";
+            default:      break;
+        }
+    }
+    return QAbstractTableModel::headerData( section, orientation, role );
+}
+
+Qt::ItemFlags FactsTableModel::flags(const QModelIndex &index) const
+{
+    if (! index.isValid())
+        return Qt::NoItemFlags;
+
+    Qt::ItemFlags flags = Qt::ItemIsEnabled; // non editable, draggable, dropable, selectable etc.
+
+    if (index.column() == Enabled)
+        flags |= Qt::ItemIsUserCheckable;
+
+    return flags;
+}
+
+FactsFilterProxyModel::FactsFilterProxyModel(QObject *parent) :
+    QSortFilterProxyModel(parent)
+{
+}
+
+void FactsFilterProxyModel::setNameFilter(const QString &text)
+{
+    QString filter = text.trimmed();
+
+    if (filter.compare( m_filter, Qt::CaseInsensitive ) == 0)
+        return;
+
+    QAbstractItemModel *src = sourceModel();
+    int                 num_rows = src ? src->rowCount() : 0;
+
+    if (filter.isEmpty())
+    {
+        m_matches.clear();
+    }
+    else
+    {
+        // If this is just the previous filter with more typed on to it, none
+        // of the facts that didn't match before can match now
+        bool narrowing = ! m_filter.isEmpty() && (m_matches.size() == num_rows) &&
+                         filter.contains( m_filter, Qt::CaseInsensitive );
+
+        if (! narrowing)
+        {
+            m_matches.fill( true, num_rows );
+        }
+
+        for (int k=0; k < num_rows; k++)
+        {
+            if (m_matches.testBit( k ))
+            {
+                QString name = src->index( k, FactsTableModel::Name ).data().toString();
+
+                if (! name.contains( filter, Qt::CaseInsensitive ))
+                    m_matches.clearBit( k );
+            }
+        }
+    }
+    m_filter = filter;
+
+    invalidateFilter();
+}
+
+bool FactsFilterProxyModel::filterAcceptsRow(int source_row, const QModelIndex &) const
+{
+    if (m_filter.isEmpty())
+        return true;
+
+    return (source_row < m_matches.size()) && m_matches.testBit( source_row );
+}
+
+bool FactsFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    // The checkbox column has no text to sort on
+    if (left.column() == FactsTableModel::Enabled)
+    {
+        return left.data( Qt::CheckStateRole ).toInt() < right.data( Qt::CheckStateRole ).toInt();
+    }
+    return QSortFilterProxyModel::lessThan( left, right );
+}
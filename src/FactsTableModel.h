@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 Anonymous Idiot
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FACTSTABLEMODEL_H__
+#define FACTSTABLEMODEL_H__
+
+#include <QAbstractTableModel>
+#include <QBitArray>
+#include <QSortFilterProxyModel>
+#include <QString>
+
+#include "facts.h"
+
+// The facts in a save, one per row in fact index order, as an enabled
+// checkbox, the index and the name. Toggling a checkbox only changes a
+// pending copy of the values, which apply() writes back.
+
+class FactsTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum column
+    {
+        Enabled,
+        ID,
+        Name,
+
+        COLUMN_SIZE
+    };
+
+    FactsTableModel(const facts &f, QObject *parent = nullptr);
+
+    void            apply(facts &f) const;
+
+    int             rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int             columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant        data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool            setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    QVariant        headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags   flags(const QModelIndex &index) const override;
+
+private:
+    const facts    &m_facts;
+    QBitArray       m_values;
+};
+
+// Filters on a case insensitive match against the fact name. Typing
+// more of a name only re-tests the facts that already matched.
+
+class FactsFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    FactsFilterProxyModel(QObject *parent = nullptr);
+
+    void            setNameFilter(const QString &text);
+
+protected:
+    bool            filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override;
+    bool            lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    QString         m_filter;
+    QBitArray       m_matches;
+};
+
+#endif // FACTSTABLEMODEL_H__
@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2026 Anonymous Idiot
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Headless tool that converts every STI and TGA image found in a Wizardry 8
+// install to PNG, so that mod releases can be compared asset by asset.
+// Files are located with exactly the same precedence rules the editor uses
+// (loose files, then patches, then the SLF archive) so the output is what
+// the game and editor would actually show.
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QRegExp>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SLFFile.h"
+#include "STI.h"
+#include "TGAtoQImage.h"
+
+struct exportJob
+{
+    QString subfolder;  // folder the SLF archive lives in, eg. "DATA"
+    QString slf;        // archive name, eg. "DATA.SLF"
+    QString name;       // file within the archive, eg. "ITEMS/ARROW.STI"
+    QString outRoot;
+};
+
+// The SLF archives the game keeps its images in, along with the folder
+// name each one is found in
+static const struct
+{
+    const char *subfolder;
+    const char *slf;
+} kArchives[] =
+{
+    { "DATA",   "DATA.SLF"   },
+    { "LEVELS", "LEVELS.SLF" }
+};
+
+static void usage(const char *app)
+{
+    printf("%s usage:\n  %s [<options>] <wizardry folder> <output folder> [<glob> ...]\n\n", app, app);
+    printf("  --world <name>   Export from the named Parallel World instead of the base install.\n");
+    printf("  --jobs <n>       Number of images to convert at once (default: one per CPU).\n\n");
+    printf("Globs are matched case insensitively against eg. \"DATA/ITEMS/ARROW.STI\".\n");
+    printf("Multi-frame STIs are written one PNG per frame. A manifest.json describing\n");
+    printf("every image converted is written to the output folder.\n");
+}
+
+static bool isImage(const QString &name)
+{
+    return name.endsWith( ".STI", Qt::CaseInsensitive ) ||
+           name.endsWith( ".TGA", Qt::CaseInsensitive );
+}
+
+// Case insensitive search for a single entry in a folder, since the casing of
+// folder names isn't consistent between installs
+static QString findEntry(const QDir &dir, const QString &name, QDir::Filters filters)
+{
+    QStringList entries = dir.entryList( QStringList() << name, filters | QDir::NoSymLinks | QDir::NoDotAndDotDot );
+
+    if (entries.size() == 1)
+        return dir.absoluteFilePath( entries.at(0) );
+
+    return QString();
+}
+
+static void addArchive(QMap<QString, QString> &names, const QString &slf_path)
+{
+    if (slf_path.isEmpty())
+        return;
+
+    QFile       slf( slf_path );
+    QStringList files;
+
+    if (SLFFile::isSlf( slf ))
+        files = SLFFile::listFiles( slf );
+
+    for (int k = 0; k < files.size(); k++)
+    {
+        if (isImage( files.at(k) ))
+            names.insert( files.at(k).toUpper(), files.at(k) );
+    }
+}
+
+// Everything SLFFile could possibly resolve an image name to for a given
+// archive; which copy actually gets used is left to SLFFile itself
+static QStringList collectNames(const QString &subfolder, const QString &slf, bool parallelWorld)
+{
+    QMap<QString, QString> names;
+
+    QDir    base( parallelWorld ? SLFFile::getParallelWorldPath() : SLFFile::getWizardryPath() );
+    QString loose = findEntry( base, subfolder, QDir::Dirs );
+
+    if (! loose.isEmpty())
+    {
+        QDir             looseDir( loose );
+        QDirIterator     it( loose, QDirIterator::Subdirectories );
+
+        while (it.hasNext())
+        {
+            QString file = it.next();
+
+            if (it.fileInfo().isFile() && isImage( file ))
+            {
+                QString rel = looseDir.relativeFilePath( file );
+
+                names.insert( rel.toUpper(), rel );
+            }
+        }
+    }
+
+    QDir wizPath( SLFFile::getWizardryPath() );
+
+    if (parallelWorld)
+    {
+        // Parallel worlds relocate the main archives to the top folder and
+        // don't use patches
+        addArchive( names, findEntry( wizPath, slf, QDir::Files ) );
+    }
+    else
+    {
+        QString patches = findEntry( wizPath, "PATCHES", QDir::Dirs );
+
+        if (! patches.isEmpty())
+        {
+            QDir        patchDir( patches );
+            QStringList entries = patchDir.entryList( QStringList() << "PATCH.*", QDir::Files | QDir::NoSymLinks );
+
+            for (int k = 0; k < entries.size(); k++)
+                addArchive( names, patchDir.absoluteFilePath( entries.at(k) ) );
+        }
+
+        QString folder = findEntry( wizPath, subfolder, QDir::Dirs );
+
+        if (! folder.isEmpty())
+            addArchive( names, findEntry( QDir( folder ), slf, QDir::Files ) );
+    }
+
+    return names.values();
+}
+
+static QJsonObject exportImage(const exportJob &job)
+{
+    QJsonObject entry;
+
+    entry["source"] = job.subfolder + "/" + job.name.toUpper();
+
+    SLFFile f( job.subfolder, job.slf, job.name );
+
+    if (! f.open(QFile::ReadOnly))
+    {
+        entry["error"] = "could not open";
+        return entry;
+    }
+
+    QByteArray array;
+    f.readAll( array );
+    entry["patched"] = f.isFromPatch();
+    f.close();
+
+    // PNGs keep the folder structure of the source, minus the extension
+    QString base = job.outRoot + "/" + job.subfolder + "/" + job.name.toUpper();
+    base.chop( 4 );
+
+    QDir().mkpath( QFileInfo( base ).absolutePath() );
+
+    QJsonArray frames;
+
+    if (job.name.endsWith( ".STI", Qt::CaseInsensitive ))
+    {
+        STI sti( array );
+
+        entry["type"] = "STI";
+
+        int num = sti.getNumImages();
+        for (int k = 0; k < num; k++)
+        {
+            int     x = 0, y = 0;
+            QImage  im = sti.getImage( k, &x, &y );
+            QString png = (num == 1) ? base + ".png" : QString( "%1.%2.png" ).arg( base ).arg( k, 3, 10, QChar('0') );
+
+            QJsonObject frame;
+
+            frame["file"]     = QDir( job.outRoot ).relativeFilePath( png );
+            frame["width"]    = im.width();
+            frame["height"]   = im.height();
+            frame["x_offset"] = x;
+            frame["y_offset"] = y;
+            frame["depth"]    = sti.getDepth( k );
+
+            if (im.isNull() || !im.save( png, "PNG" ))
+                frame["error"] = "could not write";
+
+            frames.append( frame );
+        }
+
+        const QVector<quint32> &palette = sti.getPalette();
+        if (palette.size() > 0)
+        {
+            QByteArray raw;
+            for (int k = 0; k < palette.size(); k++)
+            {
+                raw.append( (char)((palette[k] >> 24) & 0xff) );
+                raw.append( (char)((palette[k] >> 16) & 0xff) );
+                raw.append( (char)((palette[k] >>  8) & 0xff) );
+            }
+
+            QJsonObject pal;
+
+            pal["colours"] = palette.size();
+            pal["bits"]    = sti.getPaletteBits();
+            pal["sha1"]    = QString( QCryptographicHash::hash( raw, QCryptographicHash::Sha1 ).toHex() );
+
+            entry["palette"] = pal;
+        }
+    }
+    else
+    {
+        TGAtoQImage tga( array );
+
+        entry["type"] = "TGA";
+
+        int     x = 0, y = 0;
+        QImage  im = tga.getImage( &x, &y );
+        QString png = base + ".png";
+
+        QJsonObject frame;
+
+        frame["file"]     = QDir( job.outRoot ).relativeFilePath( png );
+        frame["width"]    = im.width();
+        frame["height"]   = im.height();
+        frame["x_offset"] = x;
+        frame["y_offset"] = y;
+        frame["depth"]    = tga.getDepth();
+
+        if (im.isNull() || !im.save( png, "PNG" ))
+            frame["error"] = "could not write";
+
+        frames.append( frame );
+    }
+
+    if (frames.isEmpty())
+        entry["error"] = "no images";
+
+    entry["frames"] = frames;
+    return entry;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QString     world;
+    QStringList args;
+    int         jobs = 0;
+
+    for (int k=1; k<argc; k++)
+    {
+        if ((strcmp( argv[k], "--help" ) == 0) || (strcmp( argv[k], "/?" ) == 0))
+        {
+            usage( argv[0] );
+            return 0;
+        }
+        else if ((strcmp( argv[k], "--world" ) == 0) && (k+1 < argc))
+            world = QString( argv[++k] );
+        else if ((strcmp( argv[k], "--jobs" ) == 0) && (k+1 < argc))
+            jobs = atoi( argv[++k] );
+        else
+            args << QString( argv[k] );
+    }
+
+    if (args.size() < 2)
+    {
+        usage( argv[0] );
+        return 1;
+    }
+
+    QString outRoot = QDir( args.at(1) ).absolutePath();
+
+    QList<QRegExp> globs;
+    for (int k = 2; k < args.size(); k++)
+        globs << QRegExp( args.at(k), Qt::CaseInsensitive, QRegExp::Wildcard );
+
+    SLFFile::setWizardryPath( args.at(0) );
+    if (! world.isEmpty())
+    {
+        SLFFile::setParallelWorld( world );
+
+        if (SLFFile::getParallelWorldPath().isEmpty())
+        {
+            fprintf( stderr, "Parallel World \"%s\" not found\n", qPrintable( world ) );
+            return 1;
+        }
+    }
+
+    if (jobs > 0)
+        QThreadPool::globalInstance()->setMaxThreadCount( jobs );
+
+    QList<exportJob> todo;
+
+    for (unsigned int k = 0; k < sizeof(kArchives) / sizeof(kArchives[0]); k++)
+    {
+        QStringList names = collectNames( kArchives[k].subfolder, kArchives[k].slf, ! world.isEmpty() );
+
+        for (int j = 0; j < names.size(); j++)
+        {
+            exportJob job = { kArchives[k].subfolder, kArchives[k].slf, names.at(j), outRoot };
+
+            bool wanted = globs.isEmpty();
+            for (int g = 0; !wanted && (g < globs.size()); g++)
+                wanted = globs[g].exactMatch( job.subfolder + "/" + job.name );
+
+            if (wanted)
+                todo << job;
+        }
+    }
+
+    if (! QDir().mkpath( outRoot ))
+    {
+        fprintf( stderr, "Could not create \"%s\"\n", qPrintable( outRoot ) );
+        return 1;
+    }
+
+    printf( "Converting %d images...\n", todo.size() );
+
+    QList<QJsonObject> results = QtConcurrent::blockingMapped( todo, exportImage );
+
+    QJsonArray manifest;
+    int        failed = 0;
+
+    for (int k = 0; k < results.size(); k++)
+    {
+        if (results.at(k).contains( "error" ))
+        {
+            fprintf( stderr, "%s: %s\n", qPrintable( results.at(k)["source"].toString() ), qPrintable( results.at(k)["error"].toString() ) );
+            failed++;
+        }
+        manifest.append( results.at(k) );
+    }
+
+    QFile m( outRoot + "/manifest.json" );
+    if (! m.open(QFile::WriteOnly))
+    {
+        fprintf( stderr, "Could not write manifest\n" );
+        return 1;
+    }
+    m.write( QJsonDocument( manifest ).toJson() );
+    m.close();
+
+    printf( "%d images converted, %d failed\n", results.size() - failed, failed );
+
+    return (failed == 0) ? 0 : 2;
+}
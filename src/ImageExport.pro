@@ -0,0 +1,34 @@
+# Headless command line tool converting the STI and TGA images of a Wizardry 8
+# install to PNG. Kept separate from the editor so it needs neither a display
+# nor Urho3D. Build with:
+#   qmake ImageExport.pro -o Makefile.ImageExport && make -f Makefile.ImageExport
+
+CC_ARCH=$$system($${QMAKE_CC} -dumpmachine)
+
+OBJECTS_DIR=.$${CC_ARCH}/ImageExport
+MOC_DIR=.$${CC_ARCH}/ImageExport
+
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE  = -O3 -msse -msse2
+QMAKE_CXXFLAGS_DEBUG    = -g  -msse -msse2 -O0 -DQ_ASSERT_IS_BROKEN -fpermissive
+
+QT       += core
+QT       += gui
+QT       += concurrent
+QT       -= widgets
+
+TARGET = ImageExport
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+SOURCES += ImageExport.cpp \
+           SLFFile.cpp \
+           STI.cpp \
+           TGAtoQImage.cpp
+
+HEADERS += SLFFile.h \
+           STI.h \
+           TGAtoQImage.h \
+           common.h
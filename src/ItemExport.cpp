@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2026 Anonymous Idiot
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ItemExport.h"
+#include "dbHelper.h"
+#include "item.h"
+#include "main.h"
+#include "spell.h"
+
+#include <QBitArray>
+#include <QFile>
+#include <QFutureWatcher>
+#include <QMetaEnum>
+#include <QProgressDialog>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <QDebug>
+
+// Items formatted by each job; small enough that the progress dialog
+// moves, big enough that the jobs aren't all overhead
+#define EXPORT_CHUNK_SIZE     128
+
+// Item and spell names and descriptions come from the localisation's
+// caches and the item database, both safe to read from any thread, so
+// the jobs look those up themselves. Type names come from the string
+// table, which isn't, so the few there are get resolved up front,
+// indexed by item::type.
+struct exportChunk
+{
+    int                      first;
+    int                      last;
+    bool                     csv;
+    const QVector<QString>  *typeNames;
+};
+
+// Builds the output a field at a time. The same field list makes the
+// CSV header line, a CSV row or a JSON object, so they can't get out of
+// step with each other.
+class rowWriter
+{
+public:
+    enum mode
+    {
+        Header,
+        Csv,
+        Json
+    };
+
+    rowWriter(mode m) : m_mode(m), m_first(true) {}
+
+    void begin()
+    {
+        m_first = true;
+
+        if (m_mode == Json)
+            m_row += '{';
+    }
+
+    void end()
+    {
+        if (m_mode == Json)
+            m_row += '}';
+
+        m_row += '\n';
+    }
+
+    void add(const char *key, const QString &value)
+    {
+        if (startField( key ))
+            m_row += (m_mode == Csv) ? csvQuote( value ) : jsonQuote( value );
+    }
+
+    void add(const char *key, const char *value)
+    {
+        add( key, QString::fromLatin1( value ) );
+    }
+
+    void add(const char *key, const QByteArray &value)
+    {
+        add( key, QString::fromLatin1( value ) );
+    }
+
+    void add(const char *key, qint64 value)
+    {
+        if (startField( key ))
+            m_row += QByteArray::number( value );
+    }
+
+    void add(const char *key, double value)
+    {
+        if (startField( key ))
+            m_row += QByteArray::number( value, 'f', 1 );
+    }
+
+    void add(const char *key, bool value)
+    {
+        if (startField( key ))
+            m_row += (m_mode == Csv) ? (value ? "1" : "0") : (value ? "true" : "false");
+    }
+
+    const QByteArray &bytes() const { return m_row; }
+
+private:
+    // Returns true if a value should follow
+    bool startField(const char *key)
+    {
+        if (! m_first)
+            m_row += ',';
+        m_first = false;
+
+        switch (m_mode)
+        {
+            case Header:
+                m_row += key;
+                return false;
+
+            case Json:
+                m_row += '"';
+                m_row += key;
+                m_row += "\":";
+                break;
+
+            default:
+                break;
+        }
+        return true;
+    }
+
+    static QByteArray csvQuote(const QString &s)
+    {
+        QByteArray b = s.toUtf8();
+
+        if ((b.indexOf( ',' ) == -1) && (b.indexOf( '"' ) == -1) &&
+            (b.indexOf( '\n' ) == -1) && (b.indexOf( '\r' ) == -1))
+        {
+            return b;
+        }
+        return '"' + b.replace( "\"", "\"\"" ) + '"';
+    }
+
+    static QByteArray jsonQuote(const QString &s)
+    {
+        QByteArray b = s.toUtf8();
+        QByteArray q;
+
+        q.reserve( b.size() + 2 );
+        q += '"';
+        for (int k=0; k < b.size(); k++)
+        {
+            char c = b.at(k);
+
+            switch (c)
+            {
+                case '"':  q += "\\\""; break;
+                case '\\': q += "\\\\"; break;
+                case '\n': q += "\\n";  break;
+                case '\r': q += "\\r";  break;
+                case '\t': q += "\\t";  break;
+                default:
+                    if ((quint8)c < 0x20)
+                        q += QString( "\\u%1" ).arg( (int)c, 4, 16, QChar('0') ).toLatin1();
+                    else
+                        q += c;
+                    break;
+            }
+        }
+        q += '"';
+
+        return q;
+    }
+
+    mode        m_mode;
+    bool        m_first;
+    QByteArray  m_row;
+};
+
+template <typename T> static const char *enumKey(int value)
+{
+    const char *key = QMetaEnum::fromType<T>().valueToKey( value );
+
+    return key ? key : "";
+}
+
+template <typename T> static QByteArray enumKeys(int value)
+{
+    return QMetaEnum::fromType<T>().valueToKeys( value );
+}
+
+static void formatItem(rowWriter &w, int id, const QVector<QString> &typeNames)
+{
+    item i( id );
+
+    quint16 min_damage = 0;
+    quint16 max_damage = 0;
+    int     damage_pct = 0;
+    int     power      = -1;
+    int     fire = 0, water = 0, air = 0, earth = 0, mental = 0, divine = 0;
+    int     skill_bonus  = 0;
+    int     attrib_bonus = 0;
+    int     artifacts    = 0;
+    int     id_spell     = 0;
+
+    i.getDamage( &min_damage, &max_damage, &damage_pct );
+    i.getResistance( &fire, &water, &air, &earth, &mental, &divine );
+    i.getIdentificationRequirement( &artifacts, &id_spell );
+
+    spell               sp     = i.getSpell( &power );
+    character::skill    sk     = i.getSkillBonus( &skill_bonus );
+    character::attribute attrib = i.getAttributeBonus( &attrib_bonus );
+
+    w.begin();
+
+    w.add( "id",                 (qint64) id );
+    w.add( "name",               i.getName() );
+    w.add( "type",               typeNames.value( i.getType() ) );
+    w.add( "type_id",            (qint64) i.getType() );
+    w.add( "weight",             i.getWeight() );
+    w.add( "price",              (qint64) i.getPrice() );
+    w.add( "ac",                 (qint64) i.getAC() );
+    w.add( "armor_weight",       (qint64) i.getArmorWeightClass() );
+    w.add( "min_damage",         (qint64) min_damage );
+    w.add( "max_damage",         (qint64) max_damage );
+    w.add( "damage_percent",     (qint64) damage_pct );
+    w.add( "to_hit",             (qint64) i.getToHit() );
+    w.add( "initiative",         (qint64) i.getInitiative() );
+    w.add( "bonus_swings",       (qint64) i.getBonusSwings() );
+    w.add( "range",              (qint64) i.getRange() );
+    w.add( "attacks",            enumKeys<item::attack>( i.getAttacks() ) );
+    w.add( "special_attacks",    enumKeys<item::special_attack>( i.getSpecialAttack() ) );
+    w.add( "poison_strength",    (qint64) i.getPoisonStrength() );
+    w.add( "slays",              (qint64) i.getSlays() );
+    w.add( "skill_used",         enumKey<character::skill>( static_cast<int>( i.getSkillUsed() ) ) );
+    w.add( "two_handed",         i.needs2Hands() );
+    w.add( "secondary",          i.canSecondary() );
+    w.add( "cursed",             i.isCursed() );
+    w.add( "max_stack",          (qint64) i.getMaxStackSize() );
+    w.add( "max_charges",        (qint64) i.getMaxCharges() );
+    w.add( "spell",              (power >= 0) ? sp.getName() : QString() );
+    w.add( "spell_id",           (qint64) ((power >= 0) ? sp.getIndex() : -1) );
+    w.add( "spell_power",        (qint64) ((power >= 0) ? power : 0) );
+    w.add( "spell_usage",        (qint64) i.getSpellUsageType() );
+    w.add( "hp_regen",           (qint64) i.getHPRegen() );
+    w.add( "stamina_regen",      (qint64) i.getStaminaRegen() );
+    w.add( "sp_regen",           (qint64) i.getSPRegen() );
+    w.add( "resist_fire",        (qint64) fire );
+    w.add( "resist_water",       (qint64) water );
+    w.add( "resist_air",         (qint64) air );
+    w.add( "resist_earth",       (qint64) earth );
+    w.add( "resist_mental",      (qint64) mental );
+    w.add( "resist_divine",      (qint64) divine );
+    w.add( "skill_bonus",        (sk != character::skill::SKILL_NONE) ? enumKey<character::skill>( static_cast<int>( sk ) ) : "" );
+    w.add( "skill_bonus_amount", (qint64) skill_bonus );
+    w.add( "attribute_bonus",    (attrib != character::attribute::ATTRIBUTE_NONE) ? enumKey<character::attribute>( static_cast<int>( attrib ) ) : "" );
+    w.add( "attribute_bonus_amount", (qint64) attrib_bonus );
+    w.add( "professions",        enumKeys<character::profession>( i.getUsableProfessions() ) );
+    w.add( "races",              enumKeys<character::race>( i.getUsableRaces() ) );
+    w.add( "genders",            enumKeys<character::gender>( i.getUsableGenders() ) );
+    w.add( "identify_artifacts", (qint64) artifacts );
+    w.add( "identify_spell",     (qint64) id_spell );
+    w.add( "description",        i.getDesc() );
+
+    w.end();
+}
+
+static QByteArray formatChunk(const exportChunk &c)
+{
+    rowWriter w( c.csv ? rowWriter::Csv : rowWriter::Json );
+
+    for (int id = c.first; id < c.last; id++)
+    {
+        formatItem( w, id, *c.typeNames );
+    }
+    return w.bytes();
+}
+
+// Writes every item in the database to @filename, as CSV if it ends in
+// .csv or as one JSON object per line otherwise. Returns the number of
+// items written, or -1 if it couldn't be.
+int exportItems( const QString &filename, QWidget *parent )
+{
+    int  num_items = dbHelper::getHelper()->getNumItems();
+    bool csv       = filename.endsWith( ".csv", Qt::CaseInsensitive );
+
+    QFile out( filename );
+
+    if (! out.open( QIODevice::WriteOnly | QIODevice::Truncate ))
+    {
+        qWarning() << "Could not open" << filename << "for the item export";
+        return -1;
+    }
+
+    // The type is a single byte in the record
+    const itemColumns &columns = dbHelper::getHelper()->getItemColumns();
+    QVector<QString>   typeNames( 256 );
+    QBitArray          resolved( 256 );
+
+    for (int k=0; k < columns.type.size(); k++)
+    {
+        quint8 t = columns.type[k];
+
+        if (! resolved.testBit( t ))
+        {
+            resolved.setBit( t );
+            typeNames[t] = ::getBaseStringTable()->getString( StringList::LISTItemTypes + t );
+        }
+    }
+
+    if (csv)
+    {
+        rowWriter header( rowWriter::Header );
+
+        formatItem( header, 0, typeNames );
+        out.write( header.bytes() );
+    }
+
+    QList<exportChunk> chunks;
+
+    for (int k=0; k < num_items; k += EXPORT_CHUNK_SIZE)
+    {
+        exportChunk c;
+
+        c.first     = k;
+        c.last      = qMin( k + EXPORT_CHUNK_SIZE, num_items );
+        c.csv       = csv;
+        c.typeNames = &typeNames;
+
+        chunks << c;
+    }
+
+    QFutureWatcher<qint64> watcher;
+    QProgressDialog        progress( QObject::tr("Exporting items..."), QObject::tr("Cancel"), 0, chunks.size(), parent );
+
+    progress.setWindowModality( Qt::WindowModal );
+
+    QObject::connect( &watcher,  &QFutureWatcher<qint64>::finished,              &progress, &QProgressDialog::reset );
+    QObject::connect( &watcher,  &QFutureWatcher<qint64>::progressRangeChanged,  &progress, &QProgressDialog::setRange );
+    QObject::connect( &watcher,  &QFutureWatcher<qint64>::progressValueChanged,  &progress, &QProgressDialog::setValue );
+    QObject::connect( &progress, &QProgressDialog::canceled,                     &watcher,  &QFutureWatcher<qint64>::cancel );
+
+    // Chunks are formatted in parallel, but the ordered reduce hands them
+    // to the writer one at a time in item order
+    watcher.setFuture( QtConcurrent::mappedReduced<qint64>( chunks, formatChunk,
+                           [&out](qint64 &written, const QByteArray &rows)
+                           {
+                               written += out.write( rows );
+                           },
+                           QtConcurrent::OrderedReduce | QtConcurrent::SequentialReduce ) );
+
+    progress.exec();
+    watcher.waitForFinished();
+
+    out.close();
+
+    if (watcher.isCanceled())
+    {
+        out.remove();
+        return -1;
+    }
+
+    return num_items;
+}
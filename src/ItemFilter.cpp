@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2026 Anonymous Idiot
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ItemFilter.h"
+#include "dbHelper.h"
+
+ItemFilter::ItemFilter() :
+    m_bits( dbHelper::getHelper()->getNumItems(), true )
+{
+}
+
+ItemFilter ItemFilter::none()
+{
+    return ItemFilter( QBitArray( dbHelper::getHelper()->getNumItems() ) );
+}
+
+// A value with no items at all won't have had a bitset made for it
+ItemFilter ItemFilter::fromSet(const QVector<QBitArray> &sets, int idx)
+{
+    if ((idx >= 0) && (idx < sets.size()))
+        return ItemFilter( sets[ idx ] );
+
+    return none();
+}
+
+ItemFilter ItemFilter::allOf(const QVector<QBitArray> &sets, quint32 bits)
+{
+    ItemFilter f;
+
+    for (int b=0; b < 32; b++)
+    {
+        if (bits & (1u << b))
+            f &= fromSet( sets, b );
+    }
+    return f;
+}
+
+ItemFilter ItemFilter::usableBy(character::professions profs)
+{
+    return allOf( dbHelper::getHelper()->getItemBitsets().professions, (quint32) profs );
+}
+
+ItemFilter ItemFilter::usableBy(character::races races)
+{
+    return allOf( dbHelper::getHelper()->getItemBitsets().races, (quint32) races );
+}
+
+ItemFilter ItemFilter::usableBy(character::genders genders)
+{
+    return allOf( dbHelper::getHelper()->getItemBitsets().genders, (quint32) genders );
+}
+
+ItemFilter ItemFilter::ofType(item::type t)
+{
+    return fromSet( dbHelper::getHelper()->getItemBitsets().type, static_cast<int>(t) );
+}
+
+ItemFilter ItemFilter::withFlag(flag f)
+{
+    const itemBitsets &s = dbHelper::getHelper()->getItemBitsets();
+
+    // Stacking values as documented against item::isStackable() etc.
+    switch (f)
+    {
+        case TwoHanded:  return ItemFilter( s.twoHanded );
+        case Secondary:  return ItemFilter( s.secondary );
+        case Cursed:     return ItemFilter( s.cursed );
+        case HasSpell:   return ItemFilter( s.hasSpell );
+        case Stackable:  return fromSet( s.stacking, 0x01 );
+        case HasCharges: return fromSet( s.stacking, 0x02 );
+        case HasUses:    return fromSet( s.stacking, 0x03 );
+        case HasShots:   return fromSet( s.stacking, 0x04 );
+    }
+    return none();
+}
+
+ItemFilter ItemFilter::withSpecialAttack(item::special_attacks attacks)
+{
+    const itemBitsets &s = dbHelper::getHelper()->getItemBitsets();
+
+    ItemFilter f = none();
+
+    for (int b=0; b < s.specialAttacks.size(); b++)
+    {
+        if (attacks & (1 << b))
+            f |= ItemFilter( s.specialAttacks[b] );
+    }
+    return f;
+}
+
+template <typename T> static QBitArray rangeOf(const QVector<T> &column, qint64 min, qint64 max)
+{
+    QBitArray bits( column.size() );
+
+    for (int k=0; k < column.size(); k++)
+    {
+        if ((column[k] >= min) && (column[k] <= max))
+            bits.setBit( k );
+    }
+    return bits;
+}
+
+// There's no bitset for these, but a pass over one column is still
+// very quick
+ItemFilter ItemFilter::inRange(field f, qint64 min, qint64 max)
+{
+    const itemColumns &c = dbHelper::getHelper()->getItemColumns();
+
+    switch (f)
+    {
+        case Weight:    return ItemFilter( rangeOf( c.weight,    min, max ) );
+        case Price:     return ItemFilter( rangeOf( c.price,     min, max ) );
+        case AC:        return ItemFilter( rangeOf( c.ac,        min, max ) );
+        case MinDamage: return ItemFilter( rangeOf( c.minDamage, min, max ) );
+        case MaxDamage: return ItemFilter( rangeOf( c.maxDamage, min, max ) );
+    }
+    return none();
+}
+
+ItemFilter &ItemFilter::operator&=(const ItemFilter &other)
+{
+    m_bits &= other.m_bits;
+    return *this;
+}
+
+ItemFilter &ItemFilter::operator|=(const ItemFilter &other)
+{
+    m_bits |= other.m_bits;
+    return *this;
+}
+
+ItemFilter ItemFilter::operator&(const ItemFilter &other) const
+{
+    return ItemFilter( m_bits & other.m_bits );
+}
+
+ItemFilter ItemFilter::operator|(const ItemFilter &other) const
+{
+    return ItemFilter( m_bits | other.m_bits );
+}
+
+ItemFilter ItemFilter::operator~() const
+{
+    return ItemFilter( ~m_bits );
+}
+
+bool ItemFilter::contains(int item_id) const
+{
+    return (item_id >= 0) && (item_id < m_bits.size()) && m_bits.testBit( item_id );
+}
+
+int ItemFilter::count() const
+{
+    return m_bits.count( true );
+}
+
+QList<quint16> ItemFilter::items() const
+{
+    QList<quint16> items;
+
+    items.reserve( count() );
+    for (int k=0; k < m_bits.size(); k++)
+    {
+        if (m_bits.testBit( k ))
+            items << (quint16)k;
+    }
+    return items;
+}
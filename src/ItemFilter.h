@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 Anonymous Idiot
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ITEMFILTER_H__
+#define ITEMFILTER_H__
+
+#include <QBitArray>
+#include <QList>
+
+#include "character.h"
+#include "item.h"
+
+// A set of items from the item database, made from the helper's per
+// attribute bitsets and combined with &, | and ~. Every filter is
+// worked out as soon as it's made, so building up an expression of
+// them is just as many bitset operations.
+//
+//   ItemFilter f = ItemFilter::usableBy( character::profession::Monk ) &
+//                  (ItemFilter::ofType( item::type::ShortWeapon ) | ItemFilter::ofType( item::type::ExtendedWeapon )) &
+//                  ~ItemFilter::withFlag( ItemFilter::Cursed );
+
+class ItemFilter
+{
+public:
+    enum flag
+    {
+        TwoHanded,
+        Secondary,
+        Cursed,
+        HasSpell,
+        Stackable,
+        HasCharges,
+        HasUses,
+        HasShots
+    };
+
+    // Fields that can be tested against a range of values. Weight is in
+    // tenths of a pound.
+    enum field
+    {
+        Weight,
+        Price,
+        AC,
+        MinDamage,
+        MaxDamage
+    };
+
+    ItemFilter();                                    // every item
+
+    static ItemFilter  none();
+
+    // Items usable by all of the given professions/races/genders. An
+    // empty set doesn't filter anything out.
+    static ItemFilter  usableBy(character::professions profs);
+    static ItemFilter  usableBy(character::races races);
+    static ItemFilter  usableBy(character::genders genders);
+
+    static ItemFilter  ofType(item::type t);
+    static ItemFilter  withFlag(flag f);
+
+    // Items with any of the given special attacks
+    static ItemFilter  withSpecialAttack(item::special_attacks attacks);
+
+    static ItemFilter  inRange(field f, qint64 min, qint64 max);
+
+    ItemFilter        &operator&=(const ItemFilter &other);
+    ItemFilter        &operator|=(const ItemFilter &other);
+
+    ItemFilter         operator&(const ItemFilter &other) const;
+    ItemFilter         operator|(const ItemFilter &other) const;
+    ItemFilter         operator~() const;
+
+    bool               contains(int item_id) const;
+    int                count() const;
+
+    const QBitArray   &bits() const { return m_bits; }
+    QList<quint16>     items() const;
+
+private:
+    ItemFilter(const QBitArray &bits) : m_bits(bits) {}
+
+    static ItemFilter  fromSet(const QVector<QBitArray> &sets, int idx);
+    static ItemFilter  allOf(const QVector<QBitArray> &sets, quint32 bits);
+
+    QBitArray          m_bits;
+};
+
+#endif // ITEMFILTER_H__
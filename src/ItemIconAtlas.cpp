@@ -0,0 +1,377 @@
+/*
+ * Copyright (C) 2026 Anonymous Idiot
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QPainter>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+#include "ItemIconAtlas.h"
+#include "SLFFile.h"
+#include "STI.h"
+#include "dbHelper.h"
+#include "item.h"
+
+#include <QDebug>
+
+static const quint32 kCacheMagic   = 0x41493857; // "W8IA"
+static const quint32 kCacheVersion = 1;
+static const int     kAtlasWidth   = 1024;
+static const int     kPadding      = 1;
+
+// Runs on the thread pool, so it must not touch anything but its argument
+static QVector<QImage> decodeSti(const QString &sti_file)
+{
+    QVector<QImage> frames;
+
+    SLFFile imgs( "ITEMS/" + sti_file );
+
+    if (imgs.open(QFile::ReadOnly))
+    {
+        QByteArray array;
+
+        imgs.readAll( array );
+        STI sti_imgs( array );
+
+        for (int k = 0; k < ItemIconAtlas::kNumFrames; k++)
+        {
+            // The image only references the STI data until copied
+            QImage im = sti_imgs.getImage( k ).copy();
+
+            if (!im.isNull() && (im.format() != QImage::Format_ARGB32))
+                im = im.convertToFormat( QImage::Format_ARGB32 );
+
+            frames << im;
+        }
+        imgs.close();
+    }
+    return frames;
+}
+
+// Folder names aren't cased consistently between installs
+static bool cdInsensitive(QDir &dir, const QString &name)
+{
+    QStringList entries = dir.entryList( QStringList() << name, QDir::Dirs | QDir::NoSymLinks | QDir::NoDotAndDotDot );
+
+    if (entries.size() == 1)
+        return dir.cd( entries.at(0) );
+
+    return false;
+}
+
+static void stampFile(QCryptographicHash &hash, const QFileInfo &fi)
+{
+    hash.addData( fi.absoluteFilePath().toUtf8() );
+    hash.addData( QByteArray::number( fi.size() ) );
+    hash.addData( QByteArray::number( fi.lastModified().toMSecsSinceEpoch() ) );
+}
+
+static void stampFolder(QCryptographicHash &hash, const QDir &dir, const QString &filter)
+{
+    stampFile( hash, QFileInfo( dir.absolutePath() ) );
+
+    QFileInfoList files = dir.entryInfoList( QStringList() << filter, QDir::Files | QDir::NoDotAndDotDot, QDir::Name | QDir::IgnoreCase );
+
+    for (int k = 0; k < files.size(); k++)
+    {
+        stampFile( hash, files.at(k) );
+    }
+}
+
+ItemIconAtlas::ItemIconAtlas() :
+    QObject(),
+    m_ready(false),
+    m_building(false)
+{
+    connect( &m_watcher, SIGNAL(finished()), this, SLOT(buildFinished()) );
+}
+
+ItemIconAtlas *ItemIconAtlas::getAtlas()
+{
+    static ItemIconAtlas *singleton = new ItemIconAtlas();
+
+    return singleton;
+}
+
+QString ItemIconAtlas::normaliseName(const QString &sti_file)
+{
+    QString name = QString(sti_file).replace("\\", "/").toUpper();
+
+    if (name.startsWith( "ITEMS/" ))
+        name = name.mid( 6 );
+
+    return name;
+}
+
+// The stamp covers everywhere SLFFile could have found an item STI: the
+// DATA folder (loose files and SLF archives) and the patch archives, in both
+// the base install and any Parallel World. Touching any of them, or a mod
+// changing which STIs the items use, invalidates the cached atlas.
+QByteArray ItemIconAtlas::makeStamp(const QStringList &stiFiles)
+{
+    QCryptographicHash hash( QCryptographicHash::Sha1 );
+
+    hash.addData( stiFiles.join( '\n' ).toUtf8() );
+
+    QStringList roots;
+    roots << SLFFile::getWizardryPath() << SLFFile::getParallelWorldPath();
+
+    for (int k = 0; k < roots.size(); k++)
+    {
+        if (roots.at(k).isEmpty())
+            continue;
+
+        hash.addData( roots.at(k).toUtf8() );
+
+        QDir data( roots.at(k) );
+        if (cdInsensitive( data, "DATA" ))
+        {
+            stampFolder( hash, data, "*.SLF" );
+
+            if (cdInsensitive( data, "ITEMS" ))
+                stampFolder( hash, data, "*.STI" );
+        }
+
+        QDir patches( roots.at(k) );
+        if (cdInsensitive( patches, "PATCHES" ))
+        {
+            stampFolder( hash, patches, "PATCH.*" );
+        }
+    }
+    return hash.result();
+}
+
+ItemIconAtlas::atlas ItemIconAtlas::loadOrBuild(const QStringList &stiFiles, const QString &cacheFile)
+{
+    atlas a;
+
+    a.stamp = makeStamp( stiFiles );
+
+    QFile cache( cacheFile );
+    if (cache.open(QFile::ReadOnly))
+    {
+        QDataStream in( &cache );
+        quint32     magic   = 0;
+        quint32     version = 0;
+        QByteArray  stamp;
+
+        in >> magic >> version >> stamp;
+
+        if ((magic == kCacheMagic) && (version == kCacheVersion) && (stamp == a.stamp))
+        {
+            in >> a.stiIndex >> a.rects >> a.image;
+
+            if ((in.status() == QDataStream::Ok) && !a.image.isNull() &&
+                (a.rects.size() == a.stiIndex.size() * kNumFrames))
+            {
+                return a;
+            }
+        }
+        cache.close();
+
+        a.stiIndex.clear();
+        a.rects.clear();
+        a.image = QImage();
+    }
+
+    QList< QVector<QImage> > decoded = QtConcurrent::blockingMapped( stiFiles, decodeSti );
+
+    // Simple shelf packing, tallest first so the shelves waste little space
+    struct placement
+    {
+        int   slot;
+        QSize size;
+    };
+    QVector<placement> todo;
+
+    a.rects.fill( QRect(), stiFiles.size() * kNumFrames );
+
+    for (int k = 0; k < stiFiles.size(); k++)
+    {
+        a.stiIndex.insert( stiFiles.at(k), k );
+
+        for (int f = 0; f < decoded.at(k).size(); f++)
+        {
+            if (!decoded.at(k).at(f).isNull())
+            {
+                placement p = { k * kNumFrames + f, decoded.at(k).at(f).size() };
+
+                todo << p;
+            }
+        }
+    }
+    std::stable_sort( todo.begin(), todo.end(), [](const placement &l, const placement &r) { return l.size.height() > r.size.height(); } );
+
+    int x = 0, y = 0, shelf = 0;
+
+    for (int k = 0; k < todo.size(); k++)
+    {
+        if ((x > 0) && (x + todo[k].size.width() > kAtlasWidth))
+        {
+            y += shelf + kPadding;
+            x  = 0;
+            shelf = 0;
+        }
+        a.rects[ todo[k].slot ] = QRect( QPoint( x, y ), todo[k].size );
+
+        x    += todo[k].size.width() + kPadding;
+        shelf = qMax( shelf, todo[k].size.height() );
+    }
+
+    a.image = QImage( kAtlasWidth, qMax( 1, y + shelf ), QImage::Format_ARGB32 );
+    a.image.fill( Qt::transparent );
+
+    QPainter p( &a.image );
+    p.setCompositionMode( QPainter::CompositionMode_Source );
+    for (int k = 0; k < todo.size(); k++)
+    {
+        int slot = todo[k].slot;
+
+        p.drawImage( a.rects[ slot ].topLeft(), decoded.at( slot / kNumFrames ).at( slot % kNumFrames ) );
+    }
+    p.end();
+
+    QDir().mkpath( QFileInfo( cacheFile ).absolutePath() );
+
+    QSaveFile out_file( cacheFile );
+    if (out_file.open(QFile::WriteOnly))
+    {
+        QDataStream out( &out_file );
+
+        out << kCacheMagic << kCacheVersion << a.stamp << a.stiIndex << a.rects << a.image;
+
+        if (!out_file.commit())
+            qWarning() << "Could not write item icon cache" << cacheFile;
+    }
+    return a;
+}
+
+void ItemIconAtlas::build()
+{
+    if (m_ready || m_building)
+        return;
+
+    // Gather the STI each item uses here rather than in the worker. It's
+    // only a walk over the in-memory records, and buildFinished() needs
+    // m_itemSti on this thread anyway to map items onto atlas entries.
+    dbHelper      *helper = dbHelper::getHelper();
+    QSet<QString>  unique;
+
+    m_itemSti.clear();
+    for (int k = 0; k < helper->getNumItems(); k++)
+    {
+        QString name = normaliseName( item( k ).getStiFile() );
+
+        m_itemSti << name;
+        unique.insert( name );
+    }
+
+    QStringList stiFiles = unique.values();
+    stiFiles.sort();
+
+    QString cacheFile = QStandardPaths::writableLocation( QStandardPaths::CacheLocation ) + "/itemicons.dat";
+
+    m_building = true;
+    m_watcher.setFuture( QtConcurrent::run( &ItemIconAtlas::loadOrBuild, stiFiles, cacheFile ) );
+}
+
+void ItemIconAtlas::buildFinished()
+{
+    m_atlas  = m_watcher.result();
+    m_pixmap = QPixmap::fromImage( m_atlas.image );
+
+    m_itemEntry.fill( -1, m_itemSti.size() );
+    for (int k = 0; k < m_itemSti.size(); k++)
+    {
+        m_itemEntry[k] = m_atlas.stiIndex.value( m_itemSti.at(k), -1 );
+    }
+
+    m_building = false;
+    m_ready    = true;
+
+    emit ready();
+}
+
+QImage ItemIconAtlas::loadDirect(const QString &sti_file, int frame)
+{
+    return decodeSti( sti_file ).value( frame );
+}
+
+QPixmap ItemIconAtlas::getItemIcon(quint32 item_id, int frame)
+{
+    if ((frame < 0) || (frame >= kNumFrames))
+        return QPixmap();
+
+    if (!m_ready)
+    {
+        build();
+    }
+    else if (item_id < (quint32)m_itemEntry.size())
+    {
+        int entry = m_itemEntry.at( item_id );
+
+        if (entry != -1)
+        {
+            QRect r = m_atlas.rects.at( entry * kNumFrames + frame );
+
+            return r.isNull() ? QPixmap() : m_pixmap.copy( r );
+        }
+    }
+    // Not built yet (or an item id the database doesn't know) - do it the slow way
+    return getStiIcon( item( item_id ).getStiFile(), frame );
+}
+
+QPixmap ItemIconAtlas::getStiIcon(const QString &sti_file, int frame)
+{
+    QString name = normaliseName( sti_file );
+
+    if (m_ready && (frame >= 0) && (frame < kNumFrames) && m_atlas.stiIndex.contains( name ))
+    {
+        QRect r = m_atlas.rects.at( m_atlas.stiIndex.value( name ) * kNumFrames + frame );
+
+        return r.isNull() ? QPixmap() : m_pixmap.copy( r );
+    }
+    return QPixmap::fromImage( loadDirect( name, frame ) );
+}
+
+QImage ItemIconAtlas::getStiImage(const QString &sti_file, int frame)
+{
+    QString name = normaliseName( sti_file );
+
+    if (m_ready && (frame >= 0) && (frame < kNumFrames) && m_atlas.stiIndex.contains( name ))
+    {
+        QRect r = m_atlas.rects.at( m_atlas.stiIndex.value( name ) * kNumFrames + frame );
+
+        return r.isNull() ? QImage() : m_atlas.image.copy( r );
+    }
+    return loadDirect( name, frame );
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 Anonymous Idiot
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ITEMICONATLAS_H__
+#define ITEMICONATLAS_H__
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QRect>
+#include <QStringList>
+#include <QVector>
+
+// Every item STI decoded once, in parallel on a background thread, and
+// packed into a single image. Frames of an item icon are then just sub
+// rectangles of it. The packed result is kept in the cache directory and
+// reused on the next run provided none of the archives it came from have
+// changed in the meantime.
+// Everything public is meant to be called from the GUI thread only.
+
+class ItemIconAtlas : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Frames kept per STI: 0 is the backpack icon, 1 the taller version
+    // used for worn slots and 2 the small one shown for weapons
+    static const int kNumFrames = 3;
+
+    struct atlas
+    {
+        QByteArray            stamp;
+        QHash<QString, int>   stiIndex;   // upper case STI filename -> entry
+        QVector<QRect>        rects;      // entry * kNumFrames + frame
+        QImage                image;
+    };
+
+    static ItemIconAtlas *getAtlas();
+
+    void       build();
+    bool       isReady() const { return m_ready; }
+
+    QPixmap    getItemIcon(quint32 item_id, int frame = 0);
+    QPixmap    getStiIcon(const QString &sti_file, int frame = 0);
+    QImage     getStiImage(const QString &sti_file, int frame = 0);
+
+signals:
+    void       ready();
+
+private slots:
+    void       buildFinished();
+
+private:
+    ItemIconAtlas();
+
+    static QString     normaliseName(const QString &sti_file);
+    static QByteArray  makeStamp(const QStringList &stiFiles);
+    static atlas       loadOrBuild(const QStringList &stiFiles, const QString &cacheFile);
+    static QImage      loadDirect(const QString &sti_file, int frame);
+
+    bool                    m_ready;
+    bool                    m_building;
+
+    atlas                   m_atlas;
+    QPixmap                 m_pixmap;
+    QStringList             m_itemSti;    // item id -> STI filename
+    QVector<qint32>         m_itemEntry;  // item id -> entry
+
+    QFutureWatcher<atlas>   m_watcher;
+};
+
+#endif // ITEMICONATLAS_H__
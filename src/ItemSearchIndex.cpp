@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) 2026 Anonymous Idiot
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <QElapsedTimer>
+
+#include <algorithm>
+
+#include "ItemSearchIndex.h"
+#include "Localisation.h"
+#include "dbHelper.h"
+
+// How long each slice of the build may hold up the event loop for
+static const int kSliceMs = 8;
+
+ItemSearchIndex::ItemSearchIndex() :
+    QObject(),
+    m_current(NULL)
+{
+    m_numItems = dbHelper::getHelper()->getNumItems();
+
+    m_timer.setInterval( 0 );
+    connect( &m_timer, SIGNAL(timeout()), this, SLOT(buildSlice()) );
+}
+
+ItemSearchIndex::~ItemSearchIndex()
+{
+    qDeleteAll( m_indexes );
+}
+
+ItemSearchIndex *ItemSearchIndex::getIndex()
+{
+    static ItemSearchIndex *singleton = new ItemSearchIndex();
+
+    return singleton;
+}
+
+// Lower case words, with accents stripped so that eg. "epee" finds "Épée"
+QStringList ItemSearchIndex::tokenise(const QString &text)
+{
+    QStringList tokens;
+    QString     word;
+    QString     decomposed = text.normalized( QString::NormalizationForm_D );
+
+    for (int k=0; k<decomposed.size(); k++)
+    {
+        const QChar c = decomposed.at(k);
+
+        if (c.category() == QChar::Mark_NonSpacing)
+            continue;
+
+        if (c.isLetterOrNumber())
+        {
+            word += c.toCaseFolded();
+        }
+        else if (! word.isEmpty())
+        {
+            tokens << word;
+            word.clear();
+        }
+    }
+    if (! word.isEmpty())
+        tokens << word;
+
+    return tokens;
+}
+
+void ItemSearchIndex::build()
+{
+    if (m_current)
+    {
+        if (! isReady() && ! m_timer.isActive())
+            m_timer.start();
+        return;
+    }
+
+    m_key = Localisation::getLocalisation()->getLanguageKey();
+
+    if (m_indexes.contains( m_key ))
+    {
+        m_current = m_indexes.value( m_key );
+    }
+    else
+    {
+        m_current = new index;
+        m_current->done = 0;
+        m_current->names.resize( m_numItems );
+
+        m_indexes.insert( m_key, m_current );
+    }
+
+    if (isReady())
+    {
+        emit ready();
+    }
+    else
+    {
+        m_timer.start();
+    }
+}
+
+// Called whenever the language or mod strings change. A partly built index
+// is thrown away, but finished ones are kept for if the language comes back.
+void ItemSearchIndex::invalidate()
+{
+    if (! m_current)
+        return;
+
+    m_timer.stop();
+
+    if (! isReady())
+    {
+        m_indexes.remove( m_key );
+        delete m_current;
+    }
+    m_current = NULL;
+
+    build();
+
+    emit updated();
+}
+
+void ItemSearchIndex::addText(index *idx, quint16 item_id, field f, const QString &text)
+{
+    QStringList tokens = tokenise( text );
+
+    for (int k=0; k<tokens.size(); k++)
+    {
+        hit h;
+
+        h.item_id  = item_id;
+        h.field    = f;
+        h.position = (quint8) qMin( k, 255 );
+
+        QVector<hit> &hits = idx->words[ tokens[k] ];
+
+        // Only the first occurrence of a word within a field matters
+        if (hits.isEmpty() || (hits.last().item_id != item_id) || (hits.last().field != f))
+            hits << h;
+    }
+
+    if (f == Name)
+        idx->names[ item_id ] = tokens.join(' ');
+}
+
+void ItemSearchIndex::buildSlice()
+{
+    if (! m_current)
+    {
+        m_timer.stop();
+        return;
+    }
+
+    Localisation  *loc = Localisation::getLocalisation();
+    QElapsedTimer  t;
+
+    t.start();
+
+    while ((m_current->done < m_numItems) && (t.elapsed() < kSliceMs))
+    {
+        quint16 item_id = (quint16) m_current->done;
+
+        addText( m_current, item_id, Name,        loc->getItemName( item_id ) );
+        addText( m_current, item_id, Description, loc->getItemDesc( item_id ) );
+
+        m_current->done++;
+    }
+
+    emit updated();
+
+    if (isReady())
+    {
+        m_timer.stop();
+
+        emit ready();
+    }
+}
+
+QList<quint16> ItemSearchIndex::search(const QString &query) const
+{
+    QList<quint16>  results;
+    QStringList     terms = tokenise( query );
+
+    if (! m_current || terms.isEmpty())
+        return results;
+
+    QHash<quint16, int> scores;
+
+    for (int t=0; t<terms.size(); t++)
+    {
+        const QString       &term = terms.at(t);
+        QHash<quint16, int>  termScores;
+
+        // Every indexed word starting with the term is contiguous in the map
+        QMap<QString, QVector<hit> >::const_iterator it = m_current->words.lowerBound( term );
+
+        for (; (it != m_current->words.constEnd()) && it.key().startsWith( term ); ++it)
+        {
+            bool exact = (it.key().size() == term.size());
+
+            const QVector<hit> &hits = it.value();
+            for (int k=0; k<hits.size(); k++)
+            {
+                const hit &h = hits.at(k);
+                int        s;
+
+                if (h.field == Name)
+                {
+                    // Words earlier in the name count for more
+                    s = (exact ? 100 : 60) - qMin( (int)h.position, 10 ) * 2;
+                }
+                else
+                {
+                    s = exact ? 20 : 10;
+                }
+
+                if (s > termScores.value( h.item_id, 0 ))
+                    termScores[ h.item_id ] = s;
+            }
+        }
+
+        // Items have to match every term
+        if (t == 0)
+        {
+            scores = termScores;
+        }
+        else
+        {
+            QMutableHashIterator<quint16, int> i( scores );
+            while (i.hasNext())
+            {
+                i.next();
+
+                if (termScores.contains( i.key() ))
+                    i.value() += termScores.value( i.key() );
+                else
+                    i.remove();
+            }
+        }
+
+        if (scores.isEmpty())
+            return results;
+    }
+
+    // Names that start with the query as typed are what's most likely wanted
+    QString phrase = terms.join(' ');
+
+    QMutableHashIterator<quint16, int> i( scores );
+    while (i.hasNext())
+    {
+        i.next();
+
+        if (m_current->names.at( i.key() ).startsWith( phrase ))
+            i.value() += 50;
+
+        results << i.key();
+    }
+
+    const QVector<QString> &names = m_current->names;
+
+    std::sort( results.begin(), results.end(), [&scores, &names](quint16 l, quint16 r)
+    {
+        int sl = scores.value( l );
+        int sr = scores.value( r );
+
+        if (sl != sr)
+            return sl > sr;
+
+        int c = names.at( l ).compare( names.at( r ) );
+        if (c != 0)
+            return c < 0;
+
+        return l < r;
+    });
+
+    return results;
+}
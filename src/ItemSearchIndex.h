@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Anonymous Idiot
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ITEMSEARCHINDEX_H__
+#define ITEMSEARCHINDEX_H__
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+// Prefix searchable index of the words in every item's localised name
+// and description. Names and descriptions have to come through
+// Localisation, which isn't safe to use off the GUI thread, so the index
+// is built incrementally there instead: a slice of items at a time from a
+// zero length timer, leaving the event loop free in between. Searches
+// made before it is finished just see the items indexed so far.
+// Indexes already completed are kept per language, so switching back to
+// one is immediate.
+
+class ItemSearchIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    static ItemSearchIndex *getIndex();
+
+    void            build();
+    void            invalidate();
+
+    bool            isReady() const  { return m_current && (m_current->done == m_numItems); }
+
+    // Items matching every word of @query, the last of which may be
+    // incomplete, best match first
+    QList<quint16>  search(const QString &query) const;
+
+    static QStringList  tokenise(const QString &text);
+
+signals:
+    void            updated();
+    void            ready();
+
+private slots:
+    void            buildSlice();
+
+private:
+    ItemSearchIndex();
+    ~ItemSearchIndex();
+
+    enum field
+    {
+        Name,
+        Description
+    };
+
+    struct hit
+    {
+        quint16  item_id;
+        quint8   field;
+        quint8   position;   // word number within the field
+    };
+
+    struct index
+    {
+        int                             done;
+        QMap<QString, QVector<hit> >    words;
+        QVector<QString>                names;  // folded, by item id
+    };
+
+    void            addText(index *idx, quint16 item_id, field f, const QString &text);
+
+    int                       m_numItems;
+    QString                   m_key;
+    index                    *m_current;
+    QHash<QString, index *>   m_indexes;
+
+    QTimer                    m_timer;
+};
+
+#endif // ITEMSEARCHINDEX_H__
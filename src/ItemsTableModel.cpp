@@ -0,0 +1,770 @@
+/*
+ * Copyright (C) 2026 Anonymous Idiot
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ItemsTableModel.h"
+
+#include "Localisation.h"
+#include "StringList.h"
+#include "dbHelper.h"
+#include "main.h"
+#include "spell.h"
+
+#include <QDataStream>
+
+#include <stdlib.h>
+
+ItemsTableModel::ItemsTableModel(QObject *parent) :
+    QAbstractTableModel(parent)
+{
+    m_numItems    = dbHelper::getHelper()->getNumItems();
+    m_languageKey = Localisation::getLocalisation()->getLanguageKey();
+
+    m_collator.setCaseSensitivity( Qt::CaseInsensitive );
+}
+
+void ItemsTableModel::setColumns(const QList<DialogChooseColumns::column> &cols)
+{
+    beginResetModel();
+
+    m_cols = cols;
+    m_rows.clear();
+
+    endResetModel();
+}
+
+void ItemsTableModel::setFont(const QFont &font)
+{
+    m_font = font;
+
+    if ((m_numItems > 0) && ! m_cols.isEmpty())
+        emit dataChanged( index( 0, 0 ), index( m_numItems - 1, m_cols.size() - 1 ), QVector<int>() << Qt::FontRole );
+}
+
+// Names and a few other columns are localised, so anything already
+// worked out has to go if the language has changed since
+void ItemsTableModel::refreshIfLanguageChanged()
+{
+    QString key = Localisation::getLocalisation()->getLanguageKey();
+
+    if (key != m_languageKey)
+    {
+        m_languageKey = key;
+        m_rows.clear();
+
+        if ((m_numItems > 0) && ! m_cols.isEmpty())
+            emit dataChanged( index( 0, 0 ), index( m_numItems - 1, m_cols.size() - 1 ) );
+    }
+}
+
+int ItemsTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_numItems;
+}
+
+int ItemsTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_cols.size();
+}
+
+const ItemsTableModel::rowText &ItemsTableModel::getRow(int row) const
+{
+    if (m_rows.isEmpty())
+        m_rows.resize( m_numItems );
+
+    rowText &r = m_rows[ row ];
+
+    if (r.text.isEmpty() && ! m_cols.isEmpty())
+    {
+        item i( row );
+
+        r.numeric.resize( m_cols.size() );
+        r.number.resize( m_cols.size() );
+
+        for (int k=0; k < m_cols.size(); k++)
+        {
+            bool numeric = false;
+
+            r.text << lookupItemProperty( &i, m_cols[k], &numeric );
+            r.numeric[k] = numeric;
+            r.number[k]  = numeric ? numericKey( r.text[k] ) : 0.0;
+            r.collation << m_collator.sortKey( r.text[k] );
+        }
+    }
+    return r;
+}
+
+// All our table cells have QStrings in them, even the purely numeric ones
+// _Most_ of the numeric cells have suffixes. A few of them can have leading '+'s
+// as well.
+double ItemsTableModel::numericKey(const QString &s)
+{
+    // toDouble(), toInt() can handle leading '+'s, but they can't handle suffixes.
+    // So use the plain clib versions which can.
+    QByteArray  qb = s.toLatin1();
+    char       *end_ptr = NULL;
+
+    double d = strtod( qb.data(), &end_ptr );
+
+    if (s.isEmpty() || (end_ptr == qb.data()))
+        d = 0.0;
+
+    return d;
+}
+
+// Numbers compare as numbers if both cells are numeric, and everything
+// else on its collation key. Nothing has to be parsed here, since
+// that was all done when the row was made.
+bool ItemsTableModel::lessThan(int left_row, int right_row, int column) const
+{
+    const rowText &l = getRow( left_row );
+    const rowText &r = getRow( right_row );
+
+    if ((column < 0) || (column >= l.text.size()) || (column >= r.text.size()))
+        return false;
+
+    if (l.numeric[ column ] && r.numeric[ column ])
+        return l.number[ column ] < r.number[ column ];
+
+    return l.collation[ column ].compare( r.collation[ column ] ) < 0;
+}
+
+QVariant ItemsTableModel::data(const QModelIndex &index, int role) const
+{
+    if (! index.isValid() || (index.row() >= m_numItems) || (index.column() >= m_cols.size()))
+        return QVariant();
+
+    switch (role)
+    {
+        case Qt::DisplayRole:
+            return getRow( index.row() ).text.at( index.column() );
+
+        case Qt::TextAlignmentRole:
+            return (int)((getRow( index.row() ).numeric.at( index.column() ) ? Qt::AlignRight : Qt::AlignLeft) | Qt::AlignVCenter);
+
+        case Qt::FontRole:
+            return m_font;
+
+        case ItemIdRole:
+            return index.row();
+
+        case NumericRole:
+            return getRow( index.row() ).numeric.at( index.column() );
+
+        default:
+            break;
+    }
+    return QVariant();
+}
+
+QVariant ItemsTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((orientation == Qt::Horizontal) && (role == Qt::DisplayRole) && (section >= 0) && (section < m_cols.size()))
+    {
+        return ::getBaseStringTable()->getString( m_cols[ section ] );
+    }
+    return QAbstractTableModel::headerData( section, orientation, role );
+}
+
+Qt::ItemFlags ItemsTableModel::flags(const QModelIndex &index) const
+{
+    if (! index.isValid())
+        return Qt::NoItemFlags;
+
+    // All cells are read only, and the item is dragged by its name
+    Qt::ItemFlags f = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+
+    if (m_cols.value( index.column() ) == DialogChooseColumns::Name)
+        f |= Qt::ItemIsDragEnabled;
+
+    return f;
+}
+
+QStringList ItemsTableModel::mimeTypes() const
+{
+    QStringList mimeTypes;
+
+    mimeTypes << ITEM_MIME_TYPE
+              << "text/plain"
+              << "text/html";
+
+    return mimeTypes;
+}
+
+QMimeData *ItemsTableModel::mimeData(const QModelIndexList &indexes) const
+{
+    QMimeData  *mimeData = new QMimeData();
+    QByteArray  itemData;
+    QDataStream dataStream(&itemData, QIODevice::WriteOnly);
+
+    // Only a single item/row is allowed to be dragged
+    if (! indexes.isEmpty() && indexes[0].isValid())
+    {
+        ::item draggedItem( indexes[0].row() );
+
+        dataStream << draggedItem;
+
+        mimeData->setData( ITEM_MIME_TYPE, itemData );
+        mimeData->setText( draggedItem.getName() );
+        mimeData->setHtml( draggedItem.getCompleteData(true) );
+    }
+
+    return mimeData;
+}
+
+QString ItemsTableModel::lookupItemProperty( item *i, DialogChooseColumns::column col, bool *numeric)
+{
+    QString prop = "";
+
+    if (numeric)
+        *numeric = false;
+
+    switch (col)
+    {
+        case DialogChooseColumns::Name:
+        {
+            prop = i->getName();
+            break;
+        }
+
+        case DialogChooseColumns::Type:
+        {
+            prop = ::getBaseStringTable()->getString( StringList::LISTItemTypes + i->getType() );
+            break;
+        }
+
+        case DialogChooseColumns::Equippable:
+        {
+            switch (i->getType())
+            {
+                case item::type::ShortWeapon:
+                case item::type::ExtendedWeapon:
+                case item::type::ThrownWeapon:
+                case item::type::RangedWeapon:
+                    prop = ::getBaseStringTable()->getString( StringList::PrimaryWeapon );
+                    if (i->canSecondary())
+                    {
+                        prop += ", " + ::getBaseStringTable()->getString( StringList::SecondaryWeapon );
+                    }
+                    break;
+
+                case item::type::Ammunition: // should have secondary set - but don't
+                case item::type::Shield: // should have secondary set - but don't
+                    prop = ::getBaseStringTable()->getString( StringList::SecondaryWeapon );
+                    break;
+
+                case item::type::TorsoArmor:
+                    prop = ::getBaseStringTable()->getString( StringList::Torso );
+                    break;
+
+                case item::type::LegArmor:
+                    prop = ::getBaseStringTable()->getString( StringList::Legs );
+                    break;
+
+                case item::type::HeadGear:
+                    prop = ::getBaseStringTable()->getString( StringList::Head );
+                    break;
+
+                case item::type::Gloves:
+                    prop = ::getBaseStringTable()->getString( StringList::Hands );
+                    break;
+
+                case item::type::Shoes:
+                    prop = ::getBaseStringTable()->getString( StringList::Feet );
+                    break;
+
+                case item::type::MiscEquipment:
+                    prop = ::getBaseStringTable()->getString( StringList::MiscItem1 ) + ", " + ::getBaseStringTable()->getString( StringList::MiscItem2 );
+                    break;
+
+                case item::type::Cloak:
+                    prop = ::getBaseStringTable()->getString( StringList::Cloak );
+                    break;
+
+                default:
+                    break;
+            }
+            break;
+        }
+
+        case DialogChooseColumns::AC:
+        {
+            if (numeric)
+                *numeric = true;
+
+            if (i->getAC() > 0)
+                prop = QString( "+%1" ).arg( i->getAC() );
+            else if (i->getAC() < 0)
+                prop = QString( "%1" ).arg( i->getAC() );
+            break;
+        }
+
+        case DialogChooseColumns::Weight:
+        {
+            if (numeric)
+                *numeric = true;
+
+            prop = QString( tr("%1 pounds") ).arg( i->getWeight(), 0, 'f', 1 );
+            break;
+        }
+
+        case DialogChooseColumns::WeightClass:
+        {
+            prop = i->getArmorWeightClassString();
+            break;
+        }
+
+        case DialogChooseColumns::Damage:
+        {
+            quint16 min_damage, max_damage;
+            int     percentage;
+
+            if (numeric)
+                *numeric = true;
+
+            i->getDamage( &min_damage, &max_damage, &percentage );
+            if (percentage != 0)
+                prop = QString( "+%1%" ).arg(percentage);
+            else if (max_damage != 0)
+                prop = QString( "%1 - %2" ).arg(min_damage).arg(max_damage);
+            break;
+        }
+
+        case DialogChooseColumns::ToHit:
+        {
+            if (numeric)
+                *numeric = true;
+
+            if (i->getToHit() > 0)
+                prop = QString( "+%1" ).arg( i->getToHit() );
+            else if (i->getToHit() < 0)
+                prop = QString( "%1" ).arg( i->getToHit() );
+            break;
+        }
+
+        case DialogChooseColumns::Initiative:
+        {
+            if (numeric)
+                *numeric = true;
+
+            if (i->getInitiative() > 0)
+                prop = QString( "+%1" ).arg( i->getInitiative() );
+            else if (i->getInitiative() < 0)
+                prop = QString( "%1" ).arg( i->getInitiative() );
+            break;
+        }
+
+        case DialogChooseColumns::Hands:
+        {
+            if (i->canSecondary())
+                prop = "Primary or Secondary";
+            else if (i->needs2Hands())
+                prop = "2 Handed Weapon";
+            else if ((i->getType() == item::type::ShortWeapon) ||
+                     (i->getType() == item::type::ExtendedWeapon) ||
+                     (i->getType() == item::type::ThrownWeapon) ||
+                     (i->getType() == item::type::RangedWeapon))
+            {
+                prop = "Primary";
+            }
+            break;
+        }
+
+        case DialogChooseColumns::Cursed:
+        {
+            switch (i->getType())
+            {
+                case item::type::ShortWeapon:
+                case item::type::ExtendedWeapon:
+                case item::type::ThrownWeapon:
+                case item::type::RangedWeapon:
+                case item::type::Shield:
+                case item::type::TorsoArmor:
+                case item::type::LegArmor:
+                case item::type::HeadGear:
+                case item::type::Gloves:
+                case item::type::Shoes:
+                case item::type::MiscEquipment:
+                case item::type::Cloak:
+                    if (! i->isCursed() )
+                        prop = "No";
+                    else
+                        prop = "Yes";
+                    break;
+
+                default:
+                    break;
+            }
+            break;
+        }
+
+        case DialogChooseColumns::SpecialAttack:
+        {
+            prop = i->getSpecialAttackString();
+            break;
+        }
+
+        case DialogChooseColumns::DoubleDamage:
+        {
+            prop = i->getSlaysString();
+            break;
+        }
+
+        case DialogChooseColumns::Price:
+        {
+            if (numeric)
+                *numeric = true;
+
+             prop = QString( "%1" ).arg( i->getPrice() );
+             break;
+        }
+
+        case DialogChooseColumns::Stackable:
+        {
+             prop = i->isStackable() ? "Yes" : "No";
+             break;
+        }
+
+        case DialogChooseColumns::SkillsUsed:
+        {
+             prop = i->getSkillUsedString();
+             break;
+        }
+
+        case DialogChooseColumns::BonusSwings:
+        {
+            if (numeric)
+                *numeric = true;
+
+            if (i->getBonusSwings() > 0)
+                prop = QString( "+%1" ).arg( i->getBonusSwings() );
+            else if (i->getBonusSwings() < 0)
+                prop = QString( "%1" ).arg( i->getBonusSwings() );
+            break;
+        }
+
+        case DialogChooseColumns::Spell:
+        {
+            int power;
+            spell spl = i->getSpell(&power);
+            QString spell_name = spl.getName();
+            if (spell_name.size() > 0)
+            {
+                if (i->getType() == item::type::Spellbook)
+                {
+                    // Don't show a power level because spellbooks don't actually "cast" the spell
+                    prop = QString( "%1 (Lvl %2)" ).arg( spell_name ).arg( spl.getLevel() );
+                }
+                else
+                {
+                    prop = QString( "%1 (Pwr %2)" ).arg( spell_name ).arg( power );
+                }
+            }
+            break;
+        }
+
+        case DialogChooseColumns::HPRegen:
+        {
+            if (numeric)
+                *numeric = true;
+
+            if (i->getHPRegen() > 0)
+                prop = QString( "+%1" ).arg( i->getHPRegen() );
+            else if (i->getHPRegen() < 0)
+                prop = QString( "%1" ).arg( i->getHPRegen() );
+            break;
+        }
+
+        case DialogChooseColumns::StaminaRegen:
+        {
+            if (numeric)
+                *numeric = true;
+
+            if (i->getStaminaRegen() > 0)
+                prop = QString( "+%1" ).arg( i->getStaminaRegen() );
+            else if (i->getStaminaRegen() < 0)
+                prop = QString( "%1" ).arg( i->getStaminaRegen() );
+            break;
+        }
+
+        case DialogChooseColumns::SPRegen:
+        {
+            if (numeric)
+                *numeric = true;
+
+            if (i->getSPRegen() > 0)
+                prop = QString( "+%1" ).arg( i->getSPRegen() );
+            else if (i->getSPRegen() < 0)
+                prop = QString( "%1" ).arg( i->getSPRegen() );
+            break;
+        }
+
+        case DialogChooseColumns::AttribBonus:
+        {
+            int bonus;
+            character::attribute a = i->getAttributeBonus( &bonus );
+
+            if ((a != character::attribute::ATTRIBUTE_NONE) && (bonus != 0))
+            {
+                QString attribStr = ::getBaseStringTable()->getString( StringList::LISTPrimaryAttributes + static_cast<int>(a) );
+
+                if (bonus > 0)
+                {
+                    prop = QString( "%1 +%2" ).arg( attribStr ).arg( bonus );
+                }
+                else
+                {
+                    prop = QString( "%1 %2" ).arg( attribStr ).arg( bonus );
+                }
+            }
+            break;
+        }
+
+        case DialogChooseColumns::SkillBonus:
+        {
+            int bonus;
+            character::skill sk = i->getSkillBonus( &bonus );
+
+            if ((sk != character::skill::SKILL_NONE) && (bonus != 0))
+            {
+                QString skillStr = ::getBaseStringTable()->getString( StringList::LISTSkills + static_cast<int>(sk) );
+
+                if (bonus > 0)
+                {
+                    prop = QString( "%1 +%2" ).arg( skillStr ).arg( bonus );
+                }
+                else
+                {
+                    prop = QString( "%1 %2" ).arg( skillStr ).arg( bonus );
+                }
+            }
+            break;
+        }
+
+        case DialogChooseColumns::MagicResistances:
+        {
+            int f=0, w=0, a=0, e=0, m=0, d=0;
+
+            if (i->getResistance(&f, &w, &a, &e, &m, &d))
+            {
+                QString list;
+
+                // Possibly a problem for some languages. Expectation is the first 2 chars of all of these are ", "
+                // so they can be jumped over for the first item in the list by the mid() call below
+                if (f) list += QString( tr(", %1% vs Fire") ).arg(f);
+                if (w) list += QString( tr(", %1% vs Water") ).arg(w);
+                if (a) list += QString( tr(", %1% vs Air") ).arg(a);
+                if (e) list += QString( tr(", %1% vs Earth") ).arg(e);
+                if (m) list += QString( tr(", %1% vs Mental") ).arg(m);
+                if (d) list += QString( tr(", %1% vs Divine") ).arg(d);
+
+                prop = list.mid(2);
+            }
+            break;
+        }
+
+        case DialogChooseColumns::Required:
+        {
+            QString required = i->getRequiredAttribsString();
+            QString required_s = i->getRequiredSkillsString();
+            if (required.size() == 0)
+            {
+                required   = required_s;
+                required_s = "";
+            }
+            /* NOT else if */
+            if (required.size() > 0)
+            {
+                if (required_s.size() > 0)
+                    required += ", " + required_s;
+
+                prop = required;
+            }
+            break;
+        }
+
+        case DialogChooseColumns::AttackModes:
+        {
+            prop = i->getAttacksString();
+            break;
+        }
+
+        case DialogChooseColumns::Special:
+        {
+            prop = i->getSpecialAttackString();
+            if (i->getBonusSwings() != 0)
+                prop += QString("; %1 bonus swings").arg( i->getBonusSwings() );
+            if (i->getHPRegen() != 0)
+                prop += QString("; %1 HP Regen").arg( i->getHPRegen() );
+            if (i->getStaminaRegen() != 0)
+                prop += QString("; %1 Stamina Regen").arg( i->getStaminaRegen() );
+            if (i->getSPRegen() != 0)
+                prop += QString("; %1 SP Regen").arg( i->getSPRegen() );
+
+            int bonus;
+            character::attribute a = i->getAttributeBonus( &bonus );
+
+            if ((a != character::attribute::ATTRIBUTE_NONE) && (bonus != 0))
+            {
+                QString attribStr = ::getBaseStringTable()->getString( StringList::LISTPrimaryAttributes + static_cast<int>(a) );
+
+                if (bonus > 0)
+                {
+                    prop += QString( "; %1 +%2" ).arg( attribStr ).arg( bonus );
+                }
+                else
+                {
+                    prop += QString( "; %1 %2" ).arg( attribStr ).arg( bonus );
+                }
+            }
+
+            character::skill sk = i->getSkillBonus( &bonus );
+
+            if ((sk != character::skill::SKILL_NONE) && (bonus != 0))
+            {
+                QString skillStr = ::getBaseStringTable()->getString( StringList::LISTSkills + static_cast<int>(sk) );
+
+                if (bonus > 0)
+                {
+                    prop += QString( "; %1 +%2" ).arg( skillStr ).arg( bonus );
+                }
+                else
+                {
+                    prop += QString( "; %1 %2" ).arg( skillStr ).arg( bonus );
+                }
+            }
+            if (prop.startsWith("; "))
+                prop = prop.mid(2);
+            break;
+        }
+
+        case DialogChooseColumns::Profs:
+        {
+            character::professions profs =  i->getUsableProfessions();
+
+            prop  = (profs & character::profession::Fighter  ) ? "F" : "-";
+            prop += (profs & character::profession::Lord     ) ? "L" : "-";
+            prop += (profs & character::profession::Valkyrie ) ? "V" : "-";
+            prop += (profs & character::profession::Ranger   ) ? "R" : "-";
+            prop += (profs & character::profession::Samurai  ) ? "S" : "-";
+            prop += (profs & character::profession::Ninja    ) ? "N" : "-";
+            prop += (profs & character::profession::Monk     ) ? "m" : "-";
+            prop += (profs & character::profession::Rogue    ) ? "r" : "-";
+            prop += (profs & character::profession::Gadgeteer) ? "G" : "-";
+            prop += (profs & character::profession::Bard     ) ? "b" : "-";
+            prop += (profs & character::profession::Priest   ) ? "p" : "-";
+            prop += (profs & character::profession::Alchemist) ? "A" : "-";
+            prop += (profs & character::profession::Bishop   ) ? "B" : "-";
+            prop += (profs & character::profession::Psionic  ) ? "P" : "-";
+            prop += (profs & character::profession::Mage     ) ? "M" : "-";
+
+            break;
+        }
+
+        case DialogChooseColumns::Races:
+        {
+            character::races races =  i->getUsableRaces();
+
+            prop  = (races & character::race::Human    ) ? "H" : "-";
+            prop += (races & character::race::Elf      ) ? "E" : "-";
+            prop += (races & character::race::Dwarf    ) ? "D" : "-";
+            prop += (races & character::race::Gnome    ) ? "G" : "-";
+            prop += (races & character::race::Hobbit   ) ? "h" : "-";
+            prop += (races & character::race::Faerie   ) ? "F" : "-";
+            prop += (races & character::race::Lizardman) ? "L" : "-";
+            prop += (races & character::race::Dracon   ) ? "d" : "-";
+            prop += (races & character::race::Felpurr  ) ? "f" : "-";
+            prop += (races & character::race::Rawulf   ) ? "R" : "-";
+            prop += (races & character::race::Mook     ) ? "M" : "-";
+            prop += (races & character::race::Trynnie  ) ? "t" : "-";
+            prop += (races & character::race::TRang    ) ? "T" : "-";
+            prop += (races & character::race::Umpani   ) ? "U" : "-";
+            prop += (races & character::race::Rapax    ) ? "r" : "-";
+            prop += (races & character::race::Android  ) ? "A" : "-";
+
+            break;
+        }
+
+        case DialogChooseColumns::Genders:
+        {
+            if (i->getUsableGenders() == character::gender::Male)
+                prop = "M-";
+            else if (i->getUsableGenders() == character::gender::Female)
+                prop = "-F";
+            else
+                prop = "MF";
+            break;
+        }
+    }
+
+    return prop;
+}
+
+ItemsFilterProxyModel::ItemsFilterProxyModel(QObject *parent) :
+    QSortFilterProxyModel(parent),
+    m_searching(false)
+{
+}
+
+// @allowed is indexed by item id. When @searching, only the items in
+// @ranked are shown, best match first
+void ItemsFilterProxyModel::setFilter(const QBitArray &allowed, bool searching, const QList<quint16> &ranked)
+{
+    m_allowed   = allowed;
+    m_searching = searching;
+
+    m_rank.clear();
+    for (int k=0; k<ranked.size(); k++)
+    {
+        m_rank.insert( ranked[k], k );
+    }
+
+    invalidate();
+}
+
+bool ItemsFilterProxyModel::filterAcceptsRow(int source_row, const QModelIndex &) const
+{
+    // Rows are item ids
+    if ((source_row >= m_allowed.size()) || ! m_allowed.testBit( source_row ))
+        return false;
+
+    if (m_searching)
+        return m_rank.contains( (quint16) source_row );
+
+    return true;
+}
+
+bool ItemsFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    if (m_searching)
+    {
+        return m_rank.value( (quint16) left.row() ) < m_rank.value( (quint16) right.row() );
+    }
+
+    if (const ItemsTableModel *m = qobject_cast<const ItemsTableModel *>( sourceModel() ))
+    {
+        return m->lessThan( left.row(), right.row(), left.column() );
+    }
+    return QSortFilterProxyModel::lessThan( left, right );
+}
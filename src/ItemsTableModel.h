@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2026 Anonymous Idiot
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ITEMSTABLEMODEL_H__
+#define ITEMSTABLEMODEL_H__
+
+#include <QAbstractTableModel>
+#include <QBitArray>
+#include <QCollator>
+#include <QFont>
+#include <QHash>
+#include <QList>
+#include <QMimeData>
+#include <QSortFilterProxyModel>
+#include <QStringList>
+#include <QVector>
+
+#include "DialogChooseColumns.h"
+#include "item.h"
+
+#define ITEM_MIME_TYPE     "application/x-wiz8-item"
+
+// Every item in the database, one per row in item id order, with a
+// column per DialogChooseColumns::column chosen. Nothing is looked up
+// until a view asks for it, and then the text for the whole row is
+// worked out at once and kept, along with the keys to sort it on.
+
+class ItemsTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum role
+    {
+        ItemIdRole  = Qt::UserRole,
+        NumericRole
+    };
+
+    ItemsTableModel(QObject *parent = nullptr);
+
+    void            setColumns(const QList<DialogChooseColumns::column> &cols);
+    void            setFont(const QFont &font);
+    void            refreshIfLanguageChanged();
+
+    int             rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int             columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant        data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant        headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags   flags(const QModelIndex &index) const override;
+
+    QStringList     mimeTypes() const override;
+    QMimeData      *mimeData(const QModelIndexList &indexes) const override;
+
+    bool            lessThan(int left_row, int right_row, int column) const;
+
+    static QString  lookupItemProperty( item *i, DialogChooseColumns::column col, bool *numeric );
+
+private:
+    struct rowText
+    {
+        QStringList             text;
+        QVector<bool>           numeric;
+
+        // Sort keys, one of each per column
+        QVector<double>         number;
+        QList<QCollatorSortKey> collation;
+    };
+
+    static double   numericKey(const QString &s);
+
+    const rowText  &getRow(int row) const;
+
+    QList<DialogChooseColumns::column>  m_cols;
+    QFont                               m_font;
+    int                                 m_numItems;
+    QString                             m_languageKey;
+    QCollator                           m_collator;
+
+    mutable QVector<rowText>            m_rows;     // empty until a view asks
+};
+
+// Filters on a set of allowed item ids, and sorts either on the model's
+// sort keys or when a search is in effect, on the search ranking.
+
+class ItemsFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    ItemsFilterProxyModel(QObject *parent = nullptr);
+
+    void            setFilter(const QBitArray &allowed, bool searching, const QList<quint16> &ranked);
+
+protected:
+    bool            filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override;
+    bool            lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    QBitArray           m_allowed;
+    bool                m_searching;
+    QHash<quint16, int> m_rank;
+};
+
+#endif // ITEMSTABLEMODEL_H__
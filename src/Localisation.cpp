@@ -29,11 +29,11 @@
 #include "SLFFile.h"
 #include "main.h"
 #include "dbHelper.h"
+#include "Settings.h"
 
 #include <QByteArray>
 #include <QDirIterator>
 #include <QMapIterator>
-#include <QSettings>
 #include <QTextCodec>
 
 #include <QDebug>
@@ -102,6 +102,14 @@ Localisation::Localisation()
     {
         init();
     }
+
+    // Anything already decoded with the old codepage is now wrong
+    QObject::connect( Settings::getSettings(), &Settings::valueChanged,
+                      [this]( const QString &key, const QVariant & )
+                      {
+                          if (key == "Codepage")
+                              flushNameCache();
+                      } );
 }
 
 Localisation::~Localisation()
@@ -116,9 +124,24 @@ bool Localisation::isLocalisationActive()
     return m_localisationActive;
 }
 
+// Identifies everything that changes the names and descriptions handed
+// out, for anything that keeps its own copies of them to compare against
+QString Localisation::getLanguageKey()
+{
+    QString key = isLocalisationActive() ? m_language : QString("-");
+
+    if (::getIgnoreModStrings())
+        key += "/nomod";
+
+    // Non-Unicode strings are decoded with the preferred codepage
+    key += "/" + Settings::getSettings()->value( "Codepage" ).toString();
+
+    return key;
+}
+
 void Localisation::init()
 {
-    QSettings settings;
+    Settings *settings = Settings::getSettings();
 
     m_moduleName = getModuleName();
 
@@ -128,11 +151,11 @@ void Localisation::init()
     determineOriginalLanguage();
     qDebug() << "Original Language determined to be:" << m_originalLanguage;
 
-    QVariant isocode = settings.value( "PreferredLanguage" );
+    QVariant isocode = settings->value( "PreferredLanguage" );
 
     if (isocode.isNull())
     {
-        settings.setValue( "PreferredLanguage", "ENG" );
+        settings->setValue( "PreferredLanguage", "ENG" );
         setLanguage( "ENG" );
     }
     else
@@ -150,6 +173,8 @@ void Localisation::init()
 // ever changed after the initial setup of the app.
 void Localisation::reset()
 {
+    flushNameCache();
+
     m_langs.clear();
     m_stringTable.clear();
 
@@ -255,15 +280,11 @@ QString Localisation::findLocalisationFolder( QString module_name )
 
 QString Localisation::decode( const char *data, int lenInBytes, bool is16bit)
 {
-    QString    str;
-    QSettings  settings;
+    QString     str;
+    QTextCodec *codec = Settings::getSettings()->getCodec();
 
-    QByteArray codepage = settings.value( "Codepage" ).toString().toLatin1();
-
-    if (codepage != "UTF16LE")
+    if (codec)
     {
-        QTextCodec *codec = QTextCodec::codecForName(codepage.constData());
-
         QByteArray r;
         for (int k=0; k<lenInBytes; k+=(is16bit ? 2 : 1))
         {
@@ -373,6 +394,8 @@ void Localisation::setLanguage( QString language )
     {
         m_language = language;
 
+        flushNameCache();
+
         readStringTable();
         readItemsDb();
         readItemsDescDb();
@@ -558,6 +581,7 @@ void Localisation::processFanPatch()
             f->close(); // Will be deleted by fanPatch going out of scope
         }
     }
+    flushNameCache();
 }
 
 QStringList Localisation::processFanPatchDescsDb( QByteArray ba )
@@ -606,7 +630,107 @@ QStringList Localisation::processFanPatchNamesDb( QByteArray ba, int record_size
     return s;
 }
 
+void Localisation::flushNameCache()
+{
+    m_cache_lock.lockForWrite();
+
+    m_itemNameCache.clear();
+    m_itemDescCache.clear();
+    m_spellNameCache.clear();
+    m_spellDescCache.clear();
+
+    m_cache_lock.unlock();
+}
+
+QString Localisation::lookupCachedName( const QHash<int, QString> &cache, int idx, bool *found )
+{
+    QString s;
+
+    m_cache_lock.lockForRead();
+
+    QHash<int, QString>::const_iterator it = cache.constFind( idx );
+
+    *found = (it != cache.constEnd());
+    if (*found)
+        s = it.value();
+
+    m_cache_lock.unlock();
+
+    return s;
+}
+
+void Localisation::storeCachedName( QHash<int, QString> &cache, int idx, const QString &s )
+{
+    m_cache_lock.lockForWrite();
+    cache.insert( idx, s );
+    m_cache_lock.unlock();
+}
+
 QString Localisation::getItemName( int idx )
+{
+    if (idx == -1)
+        return "";
+
+    bool    found;
+    QString s = lookupCachedName( m_itemNameCache, idx, &found );
+
+    if (! found)
+    {
+        s = decodeItemName( idx );
+        storeCachedName( m_itemNameCache, idx, s );
+    }
+    return s;
+}
+
+QString Localisation::getItemDesc( int idx )
+{
+    if (idx == -1)
+        return "";
+
+    bool    found;
+    QString s = lookupCachedName( m_itemDescCache, idx, &found );
+
+    if (! found)
+    {
+        s = decodeItemDesc( idx );
+        storeCachedName( m_itemDescCache, idx, s );
+    }
+    return s;
+}
+
+QString Localisation::getSpellName( int idx )
+{
+    if (idx == -1)
+        return "";
+
+    bool    found;
+    QString s = lookupCachedName( m_spellNameCache, idx, &found );
+
+    if (! found)
+    {
+        s = decodeSpellName( idx );
+        storeCachedName( m_spellNameCache, idx, s );
+    }
+    return s;
+}
+
+QString Localisation::getSpellDesc( int idx )
+{
+    if (idx == -1)
+        return "";
+
+    bool    found;
+    QString s = lookupCachedName( m_spellDescCache, idx, &found );
+
+    if (! found)
+    {
+        s = decodeSpellDesc( idx );
+        storeCachedName( m_spellDescCache, idx, s );
+    }
+    return s;
+}
+
+QString Localisation::decodeItemName( int idx )
 {
     if (idx == -1)
         return "";
@@ -626,9 +750,9 @@ QString Localisation::getItemName( int idx )
     // from the mod files
 
     dbHelper    *helper = dbHelper::getHelper();
-    QByteArray   db_record = helper->getItemRecord( idx );
+    const quint8 *db_record = helper->getItemRecord( idx );
 
-    QString nativeStr = decode( db_record.constData(), 0x3c, true );
+    QString nativeStr = decode( (const char *)db_record, 0x3c, true );
 
     if (!nativeStr.isEmpty() && isLocalisationActive())
     {
@@ -658,7 +782,7 @@ QString Localisation::getItemName( int idx )
     return nativeStr;
 }
 
-QString Localisation::getItemDesc( int idx )
+QString Localisation::decodeItemDesc( int idx )
 {
     if (idx == -1)
         return "";
@@ -710,7 +834,7 @@ QString Localisation::getItemDesc( int idx )
     return s;
 }
 
-QString Localisation::getSpellName( int idx )
+QString Localisation::decodeSpellName( int idx )
 {
     if (idx == -1)
         return "";
@@ -733,9 +857,12 @@ QString Localisation::getSpellName( int idx )
     // from the mod files
 
     dbHelper    *helper = dbHelper::getHelper();
-    QByteArray   db_record = helper->getSpellRecord( idx );
+    const quint8 *db_record = helper->getSpellRecord( idx );
+
+    if (db_record == NULL)
+        return "";
 
-    QString nativeStr = decode( db_record.constData()+0x19c, 0x84, true );
+    QString nativeStr = decode( (const char *)db_record + 0x19c, 0x84, true );
 
     if (!nativeStr.isEmpty() && isLocalisationActive())
     {
@@ -768,7 +895,7 @@ QString Localisation::getSpellName( int idx )
     return nativeStr;
 }
 
-QString Localisation::getSpellDesc( int idx )
+QString Localisation::decodeSpellDesc( int idx )
 {
     if (idx == -1)
         return "";
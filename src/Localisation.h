@@ -26,7 +26,9 @@
 #ifndef LOCALISATION_H__
 #define LOCALISATION_H__
 
+#include <QHash>
 #include <QMutex>
+#include <QReadWriteLock>
 #include <QString>
 
 #include "character.h"
@@ -64,8 +66,9 @@ public:
     QStringList getLanguagesAvailable()          { return m_langs; }
     void        setLanguage( QString language );
     QString     getLanguage()                    { return m_language; }
-    void        setLocalisationActive( bool on ) { m_localisationActive = on; }
+    void        setLocalisationActive( bool on ) { m_localisationActive = on; flushNameCache(); }
     bool        isLocalisationActive();
+    QString     getLanguageKey();
 
     QString     getItemName( int item_id );
     QString     getItemDesc( int item_id );
@@ -75,6 +78,15 @@ public:
     QString     getString( int idx );
 
 private:
+    void                       flushNameCache();
+    QString                    lookupCachedName( const QHash<int, QString> &cache, int idx, bool *found );
+    void                       storeCachedName( QHash<int, QString> &cache, int idx, const QString &s );
+
+    QString                    decodeItemName( int item_id );
+    QString                    decodeItemDesc( int item_id );
+    QString                    decodeSpellName( int spell_id );
+    QString                    decodeSpellDesc( int spell_id );
+
     void                       init();
     void                       determineLanguagesAvailable();
     void                       determineOriginalLanguage();
@@ -113,6 +125,17 @@ private:
     QStringList                m_fanpatch_unlocalisedSpells;
     QStringList                m_fanpatch_localisedSpellDescs;
     QStringList                m_fanpatch_unlocalisedSpellDescs;
+
+    // Names and descriptions are fixed width fields in the DB records that
+    // need decoding and comparing against FanPatch every time, and sorting
+    // or exporting the item list asks for the same ones over and over.
+    // These only hold results for the current language and FanPatch state,
+    // and are flushed whenever either changes.
+    QReadWriteLock             m_cache_lock;
+    QHash<int, QString>        m_itemNameCache;
+    QHash<int, QString>        m_itemDescCache;
+    QHash<int, QString>        m_spellNameCache;
+    QHash<int, QString>        m_spellDescCache;
 };
 
 #endif // LOCALISATION_H__
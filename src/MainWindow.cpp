@@ -32,6 +32,7 @@
 #include "DialogPatchExe.h"
 #include "DialogNewFile.h"
 #include "DialogPreferences.h"
+#include "ItemExport.h"
 #include "WindowDroppedItems.h"
 #include "WindowItemsList.h"
 #include "WindowFactEditor.h"
@@ -42,6 +43,8 @@
 #include "common.h"
 #include "main.h"
 
+#include "ItemSearchIndex.h"
+#include "dbHelper.h"
 #include "Localisation.h"
 #include "RIFFFile.h"
 #include "SLFFile.h"
@@ -52,7 +55,6 @@
 #define NPC_RECORD_SIZE              0x13d
 #define MONS_SEG_IDX_RECORD_SIZE     0x12b
 #define MONS_SEG_DATA_RECORD_SIZE    0x425
-#define MONSTER_DB_RECORD_SIZE       0x297
 
 // MainWindow is a singleton class so we can get away with this
 // even if it is bad practice. We have a second class in use on
@@ -328,6 +330,7 @@ MainWindow::~MainWindow()
 
     droppedItemsAct->deleteLater();
     findItemsAct->deleteLater();
+    exportItemsAct->deleteLater();
     factEditorAct->deleteLater();
     currPosAct->deleteLater();
     patchAct->deleteLater();
@@ -1213,6 +1216,8 @@ void MainWindow::ignoreModStrings()
 
     setIgnoreModStrings( ! getIgnoreModStrings() );
 
+    ItemSearchIndex::getIndex()->invalidate();
+
     // in case RPC characters were deleted, we have refreshes to make
     if (ScreenCommon *s = qobject_cast<ScreenCommon *>(m_contentWidget))
     {
@@ -1234,6 +1239,8 @@ void MainWindow::enableLocalisation()
         actions[k]->setEnabled( loc->isLocalisationActive() );
     }
 
+    ItemSearchIndex::getIndex()->invalidate();
+
     // in case RPC characters were deleted, we have refreshes to make
     if (ScreenCommon *s = qobject_cast<ScreenCommon *>(m_contentWidget))
     {
@@ -1248,6 +1255,8 @@ void MainWindow::changeLocalisation()
         Localisation *loc = Localisation::getLocalisation();
         loc->setLanguage( a->text() );
 
+        ItemSearchIndex::getIndex()->invalidate();
+
         // in case RPC characters were deleted, we have refreshes to make
         if (ScreenCommon *s = qobject_cast<ScreenCommon *>(m_contentWidget))
         {
@@ -1344,6 +1353,29 @@ void MainWindow::findItems()
     }
 }
 
+void MainWindow::exportItems()
+{
+    QString Path = SLFFile::getWizardryPath();
+
+    QString exportFile = ::getSaveFileName(NULL, tr("Export Items"), Path, tr("CSV (*.csv);;JSON Lines (*.jsonl)"));
+    if (exportFile.isEmpty())
+        return;
+
+    if (!exportFile.endsWith(".csv", Qt::CaseInsensitive) && !exportFile.endsWith(".jsonl", Qt::CaseInsensitive))
+        exportFile += ".csv";
+
+    int written = ::exportItems( exportFile, this );
+
+    if (written < 0)
+    {
+        statusBar()->showMessage(tr("Item export failed or was cancelled"));
+    }
+    else
+    {
+        statusBar()->showMessage(tr("Exported %1 items").arg( written ));
+    }
+}
+
 void MainWindow::findItemsClosed()
 {
     // The window close should have deleted the widget object itself
@@ -1482,6 +1514,10 @@ void MainWindow::createActions()
     findItemsAct->setStatusTip(tr("Filter and Sort all available items"));
     connect(findItemsAct, &QAction::triggered, this, &MainWindow::findItems);
 
+    exportItemsAct = new QAction(tr("Export Items..."), this);
+    exportItemsAct->setStatusTip(tr("Write every item in the database to a CSV or JSON Lines file"));
+    connect(exportItemsAct, &QAction::triggered, this, &MainWindow::exportItems);
+
     factEditorAct = new QAction(tr("Fact Editor..."), this);
     factEditorAct->setStatusTip(tr("Edit the game state fact variables"));
     connect(factEditorAct, &QAction::triggered, this, &MainWindow::factEditor);
@@ -1547,6 +1583,7 @@ void MainWindow::createMenus()
     specialMenu = menuBar()->addMenu(tr("&Special"));
     specialMenu->addAction(droppedItemsAct);
     specialMenu->addAction(findItemsAct);
+    specialMenu->addAction(exportItemsAct);
     specialMenu->addSeparator();
     specialMenu->addAction(factEditorAct);
     specialMenu->addAction(currPosAct);
@@ -1559,37 +1596,6 @@ void MainWindow::createMenus()
     helpMenu->addAction(aboutUrhoAct);
 }
 
-QMap<int, int> MainWindow::buildMonsterNpcTable()
-{
-    QMap<int, int> npcMonsters;
-
-    // Because this is the only place this application
-    // needs it, and it isn't needed unless the user has
-    // invoked the "Recruit RPC" menu and then saved, this
-    // database is accessed locally here only, and not
-    // through dbHelper.
-
-    SLFFile monsterDb("DATABASES/MONSTERS.DBS");
-
-    monsterDb.open(QIODevice::ReadOnly);
-
-    int numMonsters = monsterDb.readLEULong();
-
-    for (int k=0; k<numMonsters; k++)
-    {
-        quint8 monster_data[ MONSTER_DB_RECORD_SIZE ];
-
-        monsterDb.read( (char *)monster_data, MONSTER_DB_RECORD_SIZE );
-
-        int npc_id = FORMAT_LE16( monster_data + 0xcd );
-
-        npcMonsters[ npc_id ] = k /* monster id */;
-    }
-    monsterDb.close();
-
-    return npcMonsters;
-}
-
 int MainWindow::readMonsterIdxRecord()
 {
     quint8 monster_data[ MONS_SEG_IDX_RECORD_SIZE ];
@@ -1673,18 +1679,10 @@ void MainWindow::removeNpcFromLVLS(int npc_idx)
     // In order to convert the npc_idx/rpc_id into the
     // monster id we have to use the monsters database.
 
-    // We cache the conversion table, though, in case more
-    // than one character needs to be done during save.
+    int monster_id = dbHelper::getHelper()->getMonsterForNpc( npc_idx );
 
-    if (m_npcMonsters.isEmpty())
+    if (monster_id != -1)
     {
-        m_npcMonsters = buildMonsterNpcTable();
-    }
-
-    if (m_npcMonsters.contains( npc_idx ))
-    {
-        int monster_id = m_npcMonsters.value( npc_idx );
-
         qDebug() << "Recruited RPC" << m_rpcMap[ npc_idx ] << "has NPC index:" << npc_idx << "and monster id:" << monster_id;
 
         // Have to go through _all_ LVLS in the file looking, and
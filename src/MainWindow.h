@@ -104,6 +104,7 @@ private slots:
     void changeLocalisation();
     void droppedItems();
     void findItems();
+    void exportItems();
     void factEditor();
     void currentPosition();
     void patchExe();
@@ -127,10 +128,6 @@ private:
     int        readMonsterIdxRecord();
     int        readMonsterDataRecord();
 
-    QMap<int, int> buildMonsterNpcTable();
-
-    QMap<int, int> m_npcMonsters;
-
     QMenu *fileMenu;
     QMenu *editMenu;
     QMenu *specialMenu;
@@ -153,6 +150,7 @@ private:
     QAction *localisationAct;
     QAction *droppedItemsAct;
     QAction *findItemsAct;
+    QAction *exportItemsAct;
     QAction *factEditorAct;
     QAction *currPosAct;
     QAction *patchAct;
@@ -25,6 +25,8 @@
 
 #include <QDir>
 #include <QDirIterator>
+#include <QFileSystemWatcher>
+#include <QHash>
 #include <QStringList>
 #include <QVector>
 #include <QVectorIterator>
@@ -42,15 +44,34 @@ QVector<QString>      s_largePortraitPaths;
 QVector<QString>      s_mediumPortraitPaths;
 QVector<QString>      s_smallPortraitPaths;
 
+// Everything under %WIZDIR%/USER keyed by its upper case path relative to
+// %WIZDIR% (eg. "USER/PORTRAITS/FOO.STI"), since the files the portraits
+// DB refers to don't necessarily match the case of those on disk. Built
+// on first use and rebuilt the next time it's needed after the watcher
+// sees anything in the tree change.
+static QHash<QString, QString>  s_userFiles;
+static bool                     s_userFilesStale = true;
+static QFileSystemWatcher      *s_userWatcher    = NULL;
+
 static void loadPortraitsDb();
 static bool parsePortraitDb( QString filename );
+static void indexUserFiles();
 
-void loadPortraitsDb()
+void indexUserFiles()
 {
-    // For now _only_ supporting %WIZDIR%/USER/PORTRAITS and _not_
-    // %MOD%/Data/DATABASES/PortraitsSTI.dat
-    // TODO: Haven't even determined which gets precedence, or is
-    // it both?
+    s_userFiles.clear();
+    s_userFilesStale = false;
+
+    if (s_userWatcher == NULL)
+    {
+        s_userWatcher = new QFileSystemWatcher();
+
+        QObject::connect( s_userWatcher, &QFileSystemWatcher::directoryChanged, [](const QString &) { s_userFilesStale = true; } );
+    }
+    else if (! s_userWatcher->directories().isEmpty())
+    {
+        s_userWatcher->removePaths( s_userWatcher->directories() );
+    }
 
     QDir         userDir( SLFFile::getWizardryPath() );
     QStringList  filter;
@@ -62,20 +83,53 @@ void loadPortraitsDb()
     {
         userDir.cd( entries.at(0) );
 
-        QDirIterator it( userDir, QDirIterator::Subdirectories);
+        QStringList dirs;
+        dirs << userDir.absolutePath();
+
+        QDirIterator it( userDir.absolutePath(), QDir::AllEntries | QDir::NoDotAndDotDot, QDirIterator::Subdirectories );
         while (it.hasNext())
         {
             QString file = it.next();
 
-            if (file.compare( userDir.absoluteFilePath( "PortraitsSTI.dat" ), Qt::CaseInsensitive ) == 0)
-            {
-//                qDebug() << "Found" << file;
-                if (parsePortraitDb( file ))
-                {
-                    s_portraitsAvailable = true;
-                    return;
-                }
-            }
+            if (it.fileInfo().isDir())
+                dirs << file;
+            else
+                s_userFiles.insert( "USER/" + userDir.relativeFilePath( file ).toUpper(), file );
+        }
+
+        s_userWatcher->addPaths( dirs );
+    }
+}
+
+QString findUserFile( const QString &path )
+{
+    if (s_userFilesStale)
+        indexUserFiles();
+
+    return s_userFiles.value( QString(path).replace("\\", "/").toUpper() );
+}
+
+void invalidateUserFiles()
+{
+    s_userFilesStale = true;
+}
+
+void loadPortraitsDb()
+{
+    // For now _only_ supporting %WIZDIR%/USER/PORTRAITS and _not_
+    // %MOD%/Data/DATABASES/PortraitsSTI.dat
+    // TODO: Haven't even determined which gets precedence, or is
+    // it both?
+
+    QString file = findUserFile( "USER/PortraitsSTI.dat" );
+
+    if (!file.isEmpty())
+    {
+//        qDebug() << "Found" << file;
+        if (parsePortraitDb( file ))
+        {
+            s_portraitsAvailable = true;
+            return;
         }
     }
     s_initFailed = true;
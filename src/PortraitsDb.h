@@ -56,4 +56,7 @@ QString getMediumPortraitFromPortraitDB( int portraitIdx );
 QString getSmallPortraitFromPortraitDB( int portraitIdx );
 QVector<int> getIdsForPortraitCategory( portrait_category category);
 
+QString findUserFile( const QString &path );
+void    invalidateUserFiles();
+
 #endif /* _PORTRAITS_DB_H__ */
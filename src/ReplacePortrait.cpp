@@ -24,13 +24,18 @@
  */
 
 #include "ReplacePortrait.h"
+#include "PortraitsDb.h"
 #include "SLFFile.h"
 #include "STI.h"
 #include "main.h"
 
 #include <QDirIterator>
 #include <QFile>
+#include <QFutureWatcher>
 #include <QImage>
+#include <QProgressDialog>
+#include <QSet>
+#include <QtConcurrent>
 #include "ScreenCommon.h"
 #include "common.h"
 
@@ -72,20 +77,78 @@ public:
     quint32 file_offset;
 };
 
+// The three STIs that make up one portrait, ready to go in the patch file
+struct portraitPatch
+{
+    int         portraitId;
+    QString     filename;       // source image, for batch imports
+
+    QString     smallName;
+    QString     mediumName;
+    QString     largeName;
+
+    QByteArray  smallSTI;       // all empty if the portrait is being reset
+    QByteArray  mediumSTI;
+    QByteArray  largeSTI;
+};
+
+static portraitPatch makePortraitPatch( int portraitId )
+{
+    portraitPatch p;
+
+    p.portraitId = portraitId;
+    p.smallName  = ScreenCommon::getSmallPortraitName( portraitId );
+    p.mediumName = ScreenCommon::getMediumPortraitName( portraitId );
+    p.largeName  = ScreenCommon::getLargePortraitName( portraitId );
+
+    return p;
+}
+
+static QImage loadPortraitSource( const QString &filename )
+{
+    QImage img( filename );
+
+    if (img.isNull() || ((img.width() == PORTRAIT_WIDTH) && (img.height() == PORTRAIT_HEIGHT)))
+        return img;
+
+    return img.scaled( PORTRAIT_WIDTH, PORTRAIT_HEIGHT, Qt::IgnoreAspectRatio, Qt::SmoothTransformation );
+}
+
+// Only touches its argument, so safe to run on the thread pool
+static void encodePortrait( portraitPatch &p, const QImage &largeImage )
+{
+    if (largeImage.isNull())
+        return;
+
+    p.largeSTI = STI::makeSTI( largeImage );
+
+    qDebug() << "Size of LARGE STI image:" << p.largeSTI.size();
+
+    QImage mediumImage = quantise( largeImage.scaledToWidth( 90, Qt::SmoothTransformation ), 255 );
+
+    p.mediumSTI = STI::makeSTI( mediumImage, 10, false );
+
+    qDebug() << "Size of MEDIUM STI image:" << p.mediumSTI.size();
+
+    QImage smallImage = largeImage.scaledToWidth( 45, Qt::SmoothTransformation );
+
+    p.smallSTI = STI::makeSTI( smallImage );
+
+    qDebug() << "Size of SMALL STI image:" << p.smallSTI.size();
+}
+
+static void encodePortraitFile( portraitPatch &p )
+{
+    encodePortrait( p, loadPortraitSource( p.filename ) );
+}
+
+static void writePatchFile( const QList<portraitPatch> &portraits );
+
 void replacePortrait( int portraitId, QString filename )
 {
     if (! filename.isEmpty())
     {
-        QImage img( filename );
-
-        if ((img.width() == PORTRAIT_WIDTH) && (img.height() == PORTRAIT_HEIGHT))
-        {
-            rebuildPatchFile( portraitId, img );
-        }
-        else
-        {
-            rebuildPatchFile( portraitId, img.scaled( PORTRAIT_WIDTH, PORTRAIT_HEIGHT, Qt::IgnoreAspectRatio, Qt::SmoothTransformation ) );
-        }
+        rebuildPatchFile( portraitId, loadPortraitSource( filename ) );
     }
     else
     {
@@ -95,9 +158,83 @@ void replacePortrait( int portraitId, QString filename )
 
 void rebuildPatchFile( int portraitId, const QImage &largeImage )
 {
-    QString smallPortraitName  = ScreenCommon::getSmallPortraitName( portraitId );
-    QString mediumPortraitName = ScreenCommon::getMediumPortraitName( portraitId );
-    QString largePortraitName  = ScreenCommon::getLargePortraitName( portraitId );
+    portraitPatch p = makePortraitPatch( portraitId );
+
+    // if largeImage is a null pixmap, we're performing the 'reset' function
+    encodePortrait( p, largeImage );
+
+    writePatchFile( QList<portraitPatch>() << p );
+}
+
+// Encodes all the images on the thread pool, then writes every one of them
+// to the patch file in one go. Images that can't be loaded are skipped rather
+// than treated as a reset. Returns the number of portraits replaced, or 0 if
+// cancelled.
+int importPortraits( const QMap<int, QString> &portraits, QWidget *parent )
+{
+    QList<portraitPatch> jobs;
+
+    // Name lookups go through SLFFile, so are kept here rather than in the jobs
+    QMapIterator<int, QString> i( portraits );
+    while (i.hasNext())
+    {
+        i.next();
+
+        portraitPatch p = makePortraitPatch( i.key() );
+
+        p.filename = i.value();
+        jobs << p;
+    }
+
+    if (jobs.isEmpty())
+        return 0;
+
+    QFutureWatcher<void> watcher;
+    QProgressDialog      progress( QObject::tr("Importing portraits..."), QObject::tr("Cancel"), 0, jobs.size(), parent );
+
+    progress.setWindowModality( Qt::WindowModal );
+
+    QObject::connect( &watcher,  &QFutureWatcher<void>::finished,              &progress, &QProgressDialog::reset );
+    QObject::connect( &watcher,  &QFutureWatcher<void>::progressRangeChanged,  &progress, &QProgressDialog::setRange );
+    QObject::connect( &watcher,  &QFutureWatcher<void>::progressValueChanged,  &progress, &QProgressDialog::setValue );
+    QObject::connect( &progress, &QProgressDialog::canceled,                   &watcher,  &QFutureWatcher<void>::cancel );
+
+    watcher.setFuture( QtConcurrent::map( jobs, encodePortraitFile ) );
+
+    progress.exec();
+    watcher.waitForFinished();
+
+    if (watcher.isCanceled())
+        return 0;
+
+    QList<portraitPatch> encoded;
+    for (int k=0; k<jobs.size(); k++)
+    {
+        if (jobs.at(k).largeSTI.isEmpty())
+            qWarning() << "Could not load portrait image" << jobs.at(k).filename;
+        else
+            encoded << jobs.at(k);
+    }
+
+    if (! encoded.isEmpty())
+        writePatchFile( encoded );
+
+    return encoded.size();
+}
+
+// Rewrites the patch file, keeping everything already in it except the
+// files belonging to @portraits, which are replaced (or just dropped, for
+// those being reset)
+void writePatchFile( const QList<portraitPatch> &portraits )
+{
+    QSet<QString> replacing;
+
+    for (int k=0; k<portraits.size(); k++)
+    {
+        replacing << portraits.at(k).smallName.toUpper()
+                  << portraits.at(k).mediumName.toUpper()
+                  << portraits.at(k).largeName.toUpper();
+    }
 
     QString &wizardryPath = SLFFile::getWizardryPath();
     QDir    patches_subfolder = wizardryPath;
@@ -211,17 +348,9 @@ void rebuildPatchFile( int portraitId, const QImage &largeImage )
 
                     QString archiveFile = QString::fromLatin1((char*)filename.constData()).replace("\\", "/");
 
-                    if (archiveFile.compare( smallPortraitName, Qt::CaseInsensitive ) == 0)
-                    {
-                        qDebug() << archiveFile << "was in pre-existing" << PATCH_FILE << "file - ignoring it because it matches SMALL version of portrait we are saving";
-                    }
-                    else if (archiveFile.compare( mediumPortraitName, Qt::CaseInsensitive ) == 0)
-                    {
-                        qDebug() << archiveFile << "was in pre-existing" << PATCH_FILE << "file - ignoring it because it matches MEDIUM version of portrait we are saving";
-                    }
-                    else if (archiveFile.compare( largePortraitName, Qt::CaseInsensitive ) == 0)
+                    if (replacing.contains( archiveFile.toUpper() ))
                     {
-                        qDebug() << archiveFile << "was in pre-existing" << PATCH_FILE << "file - ignoring it because it matches LARGE version of portrait we are saving";
+                        qDebug() << archiveFile << "was in pre-existing" << PATCH_FILE << "file - ignoring it because it matches a portrait we are saving";
                     }
                     else
                     {
@@ -243,50 +372,38 @@ void rebuildPatchFile( int portraitId, const QImage &largeImage )
             }
         }
 
-        // if largeImage is a null pixmap, we're performing the 'reset' function -
-        // restoring the portrait back to default by removing any mods
-        // of it from the patch file
-        if (! largeImage.isNull())
+        // Portraits with no STIs are being 'reset' - restored back to default
+        // by removing any mods of them from the patch file, which has already
+        // been done above
+        for (int k=0; k<portraits.size(); k++)
         {
-            QByteArray largeImageSTI = STI::makeSTI( largeImage );
-
-            qDebug() << "Size of LARGE STI image:" << largeImageSTI.size();
-
-            QImage mediumImage = quantise( largeImage.scaledToWidth( 90, Qt::SmoothTransformation ), 255 );
-
-            QByteArray mediumImageSTI = STI::makeSTI( mediumImage, 10, false );
-
-            qDebug() << "Size of MEDIUM STI image:" << mediumImageSTI.size();
-
-            QImage smallImage = largeImage.scaledToWidth( 45, Qt::SmoothTransformation );
-
-            QByteArray smallImageSTI = STI::makeSTI( smallImage );
-
-            qDebug() << "Size of SMALL STI image:" << smallImageSTI.size();
+            const portraitPatch &p = portraits.at(k);
 
+            if (p.largeSTI.isEmpty())
+                continue;
 
             // Now push our STI file replacements to the list too
             SlfEntry s;
 
-            s.filename    = largePortraitName;
+            s.filename    = p.largeName;
             s.file_offset = slf_output.size();
-            s.file_size   = largeImageSTI.size();
+            s.file_size   = p.largeSTI.size();
 
-            slf_output.append( largeImageSTI );
+            slf_output.append( p.largeSTI );
             slf_contents.append( s );
 
-            s.filename    = mediumPortraitName;
+            s.filename    = p.mediumName;
             s.file_offset = slf_output.size();
-            s.file_size   = mediumImageSTI.size();
+            s.file_size   = p.mediumSTI.size();
 
-            slf_output.append( mediumImageSTI );
+            slf_output.append( p.mediumSTI );
             slf_contents.append( s );
 
-            s.filename    = smallPortraitName;
+            s.filename    = p.smallName;
             s.file_offset = slf_output.size();
-            s.file_size   = smallImageSTI.size();
+            s.file_size   = p.smallSTI.size();
 
-            slf_output.append( smallImageSTI );
+            slf_output.append( p.smallSTI );
             slf_contents.append( s );
         }
 
@@ -365,9 +482,16 @@ void rebuildPatchFile( int portraitId, const QImage &largeImage )
         // Portraits have been updated so remove the pre-existing notions of where to 
         // find the file data for these from the SLF cache
 
-        SLFFile::flushFromCache( smallPortraitName );
-        SLFFile::flushFromCache( mediumPortraitName );
-        SLFFile::flushFromCache( largePortraitName );
+        for (int k=0; k<portraits.size(); k++)
+        {
+            SLFFile::flushFromCache( portraits.at(k).smallName );
+            SLFFile::flushFromCache( portraits.at(k).mediumName );
+            SLFFile::flushFromCache( portraits.at(k).largeName );
+        }
+
+        // Anything caching what's on disk under USER (which the watcher may
+        // not report promptly on every platform) should look again too
+        invalidateUserFiles();
     }
 
     delete src;
@@ -27,9 +27,14 @@
 #define REPLACEPORTRAIT_H
 
 #include <QImage>
+#include <QMap>
+#include <QString>
+
+class QWidget;
 
 void    replacePortrait( int portraigIdx, QString filename);
 void    rebuildPatchFile(int portraitIdx, const QImage &replace);
+int     importPortraits( const QMap<int, QString> &portraits, QWidget *parent );
 QImage  quantise( QImage src, int n_colors );
 
 #endif
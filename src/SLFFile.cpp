@@ -24,6 +24,7 @@
  */
 
 #include <QDirIterator>
+#include <QMutex>
 #include <QPixmap>
 
 #include "SLFFile.h"
@@ -35,6 +36,7 @@
 static QString                   s_wizardryPath;
 static QString                   s_worldPath;
 static QMap<QString, QString>    s_cache;
+static QMutex                    s_cache_lock; // item icons are located from worker threads
 static bool                      s_parallelWorlds = false;
 static QString                   s_world;
 
@@ -84,6 +86,7 @@ void SLFFile::setParallelWorld(QString world)
     }
 
     // flush the entire path cache because everything is different now
+    QMutexLocker locker( &s_cache_lock );
     s_cache.clear();
 }
 
@@ -137,6 +140,7 @@ void SLFFile::flushFromCache(const QString &name)
 {
     QString filename = QString(name).replace("\\", "/").toUpper();
 
+    QMutexLocker locker( &s_cache_lock );
     s_cache.remove( "B" + filename );
     s_cache.remove( "G" + filename );
 }
@@ -152,10 +156,13 @@ void SLFFile::init(const QString &name, bool force_base )
 
     QString key = (force_base ? "B" : "G") + m_filename; // Base-restricted or Global (everywhere)
 
-    if (s_cache.contains( key ))
-    {
-        QString memory = s_cache.value( key );
+    s_cache_lock.lock();
+    bool    cached = s_cache.contains( key );
+    QString memory = s_cache.value( key );
+    s_cache_lock.unlock();
 
+    if (cached)
+    {
         // empty strings in cache mean it wasn't found when search was conducted
         if (!memory.isEmpty())
         {
@@ -166,7 +173,11 @@ void SLFFile::init(const QString &name, bool force_base )
     }
     else
     {
+        // The search itself is done outside the lock; two threads racing
+        // for the same name will just both find the same answer
         setFileName( name, force_base );
+
+        QMutexLocker locker( &s_cache_lock );
         if (isGood())
         {
             s_cache.insert( key, QString("%1%2%3").arg( m_in_slf ? "1" : "0" ).arg( m_in_patch ? "1" : "0" ).arg( m_storage->fileName() ) );
@@ -664,6 +675,37 @@ bool SLFFile::isSlf(QFile &file)
     return false;
 }
 
+// Names of every file inside an SLF archive, in the order they're stored
+QStringList SLFFile::listFiles(QFile &file)
+{
+    QStringList files;
+
+    if (file.open(QFile::ReadOnly))
+    {
+        quint32   num_files;
+        quint8    buf[257];
+
+        // jump over archive name and the base folder name
+        file.seek(512);
+
+        // get the number of files in the archive
+        file.read((char*)buf, 4);
+        num_files = FORMAT_LE32(buf);
+        for (int k=(int)num_files; k > 0; k--)
+        {
+            file.seek( file.size() - 280 * k);
+
+            file.read((char*)buf, 256);
+            buf[256] = 0;
+
+            files << QString::fromLatin1((char*)buf).replace("\\", "/");
+        }
+
+        file.close();
+    }
+    return files;
+}
+
 bool SLFFile::containsFile(QFile &file, const QString &filename)
 {
     if (file.open(QFile::ReadOnly))
@@ -29,6 +29,7 @@
 #include <QDir>
 #include <QException>
 #include <QFile>
+#include <QStringList>
 
 // This class is intended to behave in the same fashion as QFile()
 // It doesn't inherit from QFile() though due to a bug in the QIODevice
@@ -83,6 +84,7 @@ public:
     void       seekToFile( QString filename );
 
     static bool isSlf(QFile &file);
+    static QStringList listFiles(QFile &file);
 
     static void setWizardryPath(QString path);
     static void setParallelWorld(QString world);
@@ -37,7 +37,8 @@
 #define STCI_ZLIB_COMP    (1 << 4)
 #define STCI_ETRLE_COMP   (1 << 5)
 
-STI::STI( QByteArray sti )
+STI::STI( QByteArray sti ) :
+    m_palette_bits(0)
 {
     const quint8 *data_ptr = (const quint8 *)sti.constData();
 
@@ -165,6 +166,11 @@ void STI::parseIndexedSTI( quint32 flags, const quint8 *data_ptr, size_t len )
 #endif
     }
 
+    m_palette_bits = col_bits;
+    m_palette.reserve( num_cols );
+    for (unsigned int k=0; k<num_cols; k++)
+        m_palette << palette[k];
+
     if (! (flags & STCI_ETRLE_COMP))
     {
         qWarning() << "Don't know the structure for an uncompressed palette-based image";
@@ -28,6 +28,7 @@
 
 #include <QByteArray>
 #include <QImage>
+#include <QVector>
 
 class image
 {
@@ -103,6 +104,11 @@ public:
         return m_image[image].getImage();
     }
 
+    // Palette of an indexed STI (as RGBA, the way it is stored internally),
+    // empty for 16 bit truecolour images
+    const QVector<quint32> &getPalette()    { return m_palette;                                            }
+    int           getPaletteBits()      { return m_palette_bits;                                       }
+
     static QByteArray makeSTI( QImage image, int num_images=1, bool true256=true );
 
 private:
@@ -113,7 +119,9 @@ private:
     static QByteArray make8BitSTI( QImage image, int num_images=1, bool true256=true );
     static QByteArray make16BitSTI( QImage image );
 
-    QList<image>  m_image;
+    QList<image>      m_image;
+    QVector<quint32>  m_palette;
+    int               m_palette_bits;
 };
 
 #endif /* STI_H__ */
@@ -27,6 +27,7 @@
 #include <QByteArray>
 #include <QColor>
 #include <QDirIterator>
+#include <QFileInfo>
 #include <QIcon>
 #include <QMainWindow>
 #include <QMenu>
@@ -46,6 +47,7 @@
 #include "PortraitsDb.h"
 
 #include "DialogRUSure.h"
+#include "ItemIconAtlas.h"
 
 #include "common.h"
 #include "main.h"
@@ -438,49 +440,23 @@ void ScreenCommon::rebuildRPCMenu( QMenu *m)
 
 QPixmap ScreenCommon::getPortraitFromFilePath( QString portraitPath )
 {
-    QDir         cwd = SLFFile::getWizardryPath();
     QPixmap      img;
 
-    QStringList  entries;
-    QStringList  filter;
+    // Custom portraits are only ever looked for under the USER folder
+    QString file = findUserFile( portraitPath );
 
-    QString normalisedPath = portraitPath.replace("\\", "/").toUpper();
-
-    // speed this up a bit by getting into the first folder at least - which should be USER
-    if (normalisedPath.startsWith("USER/"))
+    if (!file.isEmpty())
     {
-        filter << "USER";
-
-        portraitPath = normalisedPath.mid( 5 );
-
-        entries = cwd.entryList(filter, QDir::Dirs | QDir::NoSymLinks | QDir::NoDotAndDotDot );
+        QFile     portrait(file);
 
-        if (entries.size() == 1)
+        if (portrait.open(QFile::ReadOnly))
         {
-            cwd.cd( entries.at(0) );
-
-            QDirIterator it( cwd, QDirIterator::Subdirectories);
-
-            while (it.hasNext())
-            {
-                QString file = it.next();
+            QByteArray array = portrait.readAll();
+            STI c( array );
 
-                if (file.compare( cwd.absoluteFilePath( portraitPath ), Qt::CaseInsensitive ) == 0)
-                {
-                    QFile     portrait(file);
-
-                    if (portrait.open(QFile::ReadOnly))
-                    {
-                        QByteArray array = portrait.readAll();
-                        STI c( array );
-
-                        img = QPixmap::fromImage( c.getImage( 0 ) );
+            img = QPixmap::fromImage( c.getImage( 0 ) );
 
-                        portrait.close();
-                    }
-                    break;
-                }
-            }
+            portrait.close();
         }
     }
     return img;
@@ -491,6 +467,38 @@ int ScreenCommon::getInternalPortraitCount()
     return sizeof(sti_portraits)/sizeof(QString);
 }
 
+// Matches an image filename against the stock portrait names, so that
+// "hummf.png", "Lhummf.png" or "HUMMF.sti" all map to the same portrait.
+// Returns -1 if it isn't one of them. If @prefix is given it gets the
+// size prefix letter in upper case, or a null QChar if there wasn't one.
+int ScreenCommon::getPortraitIndexFromName( const QString &name, QChar *prefix )
+{
+    QString base = QFileInfo( name ).completeBaseName() + ".sti";
+
+    for (int k=0; k<getInternalPortraitCount(); k++)
+    {
+        const QString &sti = sti_portraits[ k ];
+
+        if (base.compare( sti, Qt::CaseInsensitive ) == 0)
+        {
+            if (prefix)
+                *prefix = QChar();
+            return k;
+        }
+
+        // The size prefix letter on the SLF names
+        if ((base.size() == sti.size() + 1) &&
+            QString("LMSA").contains( base.at(0), Qt::CaseInsensitive ) &&
+            (base.mid(1).compare( sti, Qt::CaseInsensitive ) == 0))
+        {
+            if (prefix)
+                *prefix = base.at(0).toUpper();
+            return k;
+        }
+    }
+    return -1;
+}
+
 QPixmap ScreenCommon::getSmallPortrait(int portraitIndex)
 {
     if (portraitIndex >= getInternalPortraitCount())
@@ -549,6 +557,20 @@ QPixmap ScreenCommon::getMediumPortrait(int portraitIndex)
 
 QPixmap ScreenCommon::getLargePortrait(int portraitIndex)
 {
+    bool    userFile = false;
+    QString file     = getLargePortraitFile( portraitIndex, &userFile );
+
+    return QPixmap::fromImage( loadPortraitImage( file, userFile ) );
+}
+
+// Works out where a large portrait is to be loaded from without loading it,
+// so the (thread safe) loading can be done elsewhere. Returns either a name
+// to look up with SLFFile, or if @userFile is set, an absolute file path.
+// The path resolution itself has to be done on the GUI thread.
+QString ScreenCommon::getLargePortraitFile(int portraitIndex, bool *userFile)
+{
+    *userFile = false;
+
     if (portraitIndex >= getInternalPortraitCount())
     {
         if (!isWizardry128())
@@ -568,11 +590,43 @@ QPixmap ScreenCommon::getLargePortrait(int portraitIndex)
             QString portraitPath = ::getLargePortraitFromPortraitDB( portraitIndex );
 //            qDebug() << "LARGE" << portraitPath;
 
-            return getPortraitFromFilePath( portraitPath );
+            *userFile = true;
+            return findUserFile( portraitPath );
         }
     }
 
-    return SLFFile::getPixmapFromSlf( getLargePortraitName( portraitIndex ), 0 );
+    return getLargePortraitName( portraitIndex );
+}
+
+QImage ScreenCommon::loadPortraitImage(const QString &file, bool userFile)
+{
+    QByteArray array;
+
+    if (userFile)
+    {
+        QFile portrait( file );
+
+        if (file.isEmpty() || !portrait.open(QFile::ReadOnly))
+            return QImage();
+
+        array = portrait.readAll();
+        portrait.close();
+    }
+    else
+    {
+        SLFFile portrait( file );
+
+        if (!portrait.open(QFile::ReadOnly))
+            return QImage();
+
+        portrait.readAll( array );
+        portrait.close();
+    }
+
+    STI c( array );
+
+    // The image only references the STI's data until copied
+    return c.getImage( 0 ).copy();
 }
 
 QString ScreenCommon::getSmallPortraitName(int portraitIndex)
@@ -869,25 +923,20 @@ void ScreenCommon::changedPortrait()
 void ScreenCommon::setSumWeapon( character::worn weapon )
 {
     QPixmap pix;
-    QString sti_file = "";
-    int     sti_idx = 0;
 
     const item w = m_party->m_chars[ m_charIdx ]->getItem( weapon );
     if (w.isNull())
     {
         if (weapon == character::worn::Weapon1a)
-            sti_file = "MAIN INTERFACE/CLAWRIGHT.STI";
+            pix = SLFFile::getPixmapFromSlf( "MAIN INTERFACE/CLAWRIGHT.STI", 0 );
         else
-            sti_file = "MAIN INTERFACE/CLAWLEFT.STI";
+            pix = SLFFile::getPixmapFromSlf( "MAIN INTERFACE/CLAWLEFT.STI", 0 );
     }
     else
     {
-        sti_file = "ITEMS/" + w.getStiFile().toUpper();
         // weapons have an index 2 small enough to fit here
-        sti_idx  = 2;
+        pix = ItemIconAtlas::getAtlas()->getItemIcon( w.getId(), 2 );
     }
-
-    pix = SLFFile::getPixmapFromSlf( sti_file, sti_idx );
     if (pix.size().height() > 26)
     {
         pix = pix.scaledToHeight( 26, Qt::SmoothTransformation );
@@ -58,10 +58,13 @@ public:
     void             setVisible(bool visible) override;
 
     static int       getInternalPortraitCount();
+    static int       getPortraitIndexFromName( const QString &name, QChar *prefix = NULL );
     static QPixmap   getPortraitFromFilePath( QString portraitPath );
     static QPixmap   getSmallPortrait(int portraitIndex);
     static QPixmap   getMediumPortrait(int portraitIndex);
     static QPixmap   getLargePortrait(int portraitIndex);
+    static QString   getLargePortraitFile(int portraitIndex, bool *userFile);
+    static QImage    loadPortraitImage(const QString &file, bool userFile);
     static bool      isCustomPortrait(int portraitIndex);
     static QString   getSmallPortraitName(int portraitIndex);
     static QString   getMediumPortraitName(int portraitIndex);
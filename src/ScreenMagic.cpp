@@ -339,15 +339,17 @@ void ScreenMagic::createList( int list_widget_idx, character::realm realm )
 
         list->setTextColorInsteadOfCheckmarks( true, lt_yellow, gr_yellow );
 
-        for (int k = 1; k < MAXIMUM_CHARACTER_SPELLS; k++)
-        {
-            spell s(k);
+        // Apparently 0 cost spells are something some mods expect to be able to do, so swap to
+        // hiding spells which have a 0 level instead, and hope no-one expects to do that also.
+        dbHelper  *helper = dbHelper::getHelper();
+        QBitArray  spells = helper->getSpellsInRealm( realm ) & ~helper->getSpellsAtLevel( 0 );
 
-            // Apparently 0 cost spells are something some mods expect to be able to do, so swap to
-            // hiding spells which have a 0 level instead, and hope no-one expects to do that also.
-            if (! s.isNull() && (s.getRealm() == realm) &&
-                (s.getLevel() > 0))
+        for (int k = 1; k < qMin( spells.size(), MAXIMUM_CHARACTER_SPELLS ); k++)
+        {
+            if (spells.testBit( k ))
             {
+                spell s(k);
+
                 QListWidgetItem *newItem = new QListWidgetItem( s.getName() + "\t" + QString::number( s.getSPCost() ) );
 
                 // The Wizardry style will align everything after the TAB to the RHS
@@ -33,8 +33,13 @@
 #include <QApplication>
 #include <QAction>
 #include <QHelpEvent>
+#include <QDirIterator>
 #include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
 #include <QMenu>
+#include <QMessageBox>
+#include <QtConcurrent>
 
 #include "common.h"
 #include "ScreenCommon.h"
@@ -215,6 +220,10 @@ ScreenPersonality::ScreenPersonality(character *c, QWidget *parent) :
     m_cmPortraitReset->setStatusTip(tr("Reset to default picture."));
     connect(m_cmPortraitReset, SIGNAL(triggered()), this, SLOT(cmPortraitReset()));
 
+    m_cmPortraitImport = new QAction( tr("Import portraits..."), this);
+    m_cmPortraitImport->setStatusTip(tr("Replace every portrait named after a stock one in a folder of images."));
+    connect(m_cmPortraitImport, SIGNAL(triggered()), this, SLOT(cmPortraitImport()));
+
     if (isWizardry128())
     {
         // Wizardry 1.2.8 ignores the patches, so this feature is pointless.
@@ -405,6 +414,7 @@ void ScreenPersonality::resetScreen(void *char_tag, void *party_tag)
     {
         q->setPixmap( ScreenCommon::getLargePortrait( m_mugIdx ) );
     }
+    preloadPortraits();
 }
 
 void ScreenPersonality::setVisible( bool visible )
@@ -496,34 +506,34 @@ void ScreenPersonality::assemblePortraitIndices()
 // @race = false -> next/prev face
 // @up   = true  -> next
 // @up   = false -> prev
-int ScreenPersonality::nextImageIdx(bool race, bool up)
+int ScreenPersonality::nextImageIdx(int mugIdx, bool race, bool up)
 {
     // First get rid of the duplicate indexes - apologies to any mods
     // who actually changed these ones.
     // FIXME: Make this a user preference
-    switch (m_mugIdx)
+    switch (mugIdx)
     {
         case 58:           // "mook.sti",   // double up of Urq
-            m_mugIdx = 65; // "urq.sti",
+            mugIdx = 65;   // "urq.sti",
             break;
         case 59:           // "trynm1.sti", // double up of Madras
-            m_mugIdx = 67; // "madras.sti",
+            mugIdx = 67;   // "madras.sti",
             break;
         case 60:           // "trynm2.sti", // double up of Sparkle
-            m_mugIdx = 68; // "sparkle.sti",
+            mugIdx = 68;   // "sparkle.sti",
             break;
         case 62:           // "trang.sti",  // double up of Drazic
-            m_mugIdx = 71; // "drazic.sti",
+            mugIdx = 71;   // "drazic.sti",
             break;
         case 63:           // "umpani.sti", // double up of Rodan
-            m_mugIdx = 73; // "rodan.sti",
+            mugIdx = 73;   // "rodan.sti",
     }
 
     for (unsigned int k=0; k<PORTRAIT_GRP_SIZE; k++)
     {
         for (int j=0; j < m_portraits[k].size(); j++)
         {
-            if (m_portraits[k][j] == m_mugIdx)
+            if (m_portraits[k][j] == mugIdx)
             {
                 if (race == false)
                 {
@@ -563,6 +573,67 @@ int ScreenPersonality::nextImageIdx(bool race, bool up)
     return -1;
 }
 
+// The large portrait for @portraitIdx, taken from the background preload
+// if it's been started for it
+QPixmap ScreenPersonality::getPortrait(int portraitIdx)
+{
+    QHash<int, QFuture<QImage> >::const_iterator it = m_portraitPreload.constFind( portraitIdx );
+
+    if (it != m_portraitPreload.constEnd())
+    {
+        // Waits for the decode if it hasn't finished yet, which is still
+        // less time than starting it from scratch
+        return QPixmap::fromImage( it.value().result() );
+    }
+    return ScreenCommon::getLargePortrait( portraitIdx );
+}
+
+// Keep the faces either side of the current one within its race, and the
+// first face of the races either side, decoding in the background so that
+// the face and race buttons have them ready.
+void ScreenPersonality::preloadPortraits()
+{
+    static const int kPreloadFaces = 4;
+
+    QList<int>  wanted;
+    int         up   = m_mugIdx;
+    int         down = m_mugIdx;
+
+    wanted << m_mugIdx;
+    for (int k=0; k < kPreloadFaces; k++)
+    {
+        up   = nextImageIdx( up,   false, true  );
+        down = nextImageIdx( down, false, false );
+
+        wanted << up << down;
+    }
+    wanted << nextImageIdx( m_mugIdx, true, true ) << nextImageIdx( m_mugIdx, true, false );
+
+    QHash<int, QFuture<QImage> >::iterator it = m_portraitPreload.begin();
+    while (it != m_portraitPreload.end())
+    {
+        if (wanted.contains( it.key() ))
+            ++it;
+        else
+            it = m_portraitPreload.erase( it );
+    }
+
+    for (int k=0; k < wanted.size(); k++)
+    {
+        int idx = wanted.at(k);
+
+        if ((idx != -1) && !m_portraitPreload.contains( idx ))
+        {
+            // Where the portrait lives has to be worked out here, only the
+            // reading and decoding can go on the worker thread
+            bool    userFile = false;
+            QString file     = ScreenCommon::getLargePortraitFile( idx, &userFile );
+
+            m_portraitPreload.insert( idx, QtConcurrent::run( &ScreenCommon::loadPortraitImage, file, userFile ) );
+        }
+    }
+}
+
 void ScreenPersonality::nextRace(bool)
 {
     if (QPushButton *q = qobject_cast<QPushButton *>(this->sender()))
@@ -571,8 +642,9 @@ void ScreenPersonality::nextRace(bool)
 
         if (WImage *q = qobject_cast<WImage *>(m_widgets[ VAL_FACELIFT ]))
         {
-            m_mugIdx = nextImageIdx(true, true);
-            q->setPixmap( ScreenCommon::getLargePortrait( m_mugIdx ) );
+            m_mugIdx = nextImageIdx(m_mugIdx, true, true);
+            q->setPixmap( getPortrait( m_mugIdx ) );
+            preloadPortraits();
         }
         // enable the Undo button now
         if (QAbstractButton *q = qobject_cast<QAbstractButton *>(m_widgets[ PERS_UNDO ]))
@@ -590,8 +662,9 @@ void ScreenPersonality::prevRace(bool)
 
         if (WImage *q = qobject_cast<WImage *>(m_widgets[ VAL_FACELIFT ]))
         {
-            m_mugIdx = nextImageIdx(true, false);
-            q->setPixmap( ScreenCommon::getLargePortrait( m_mugIdx ) );
+            m_mugIdx = nextImageIdx(m_mugIdx, true, false);
+            q->setPixmap( getPortrait( m_mugIdx ) );
+            preloadPortraits();
         }
         // enable the Undo button now
         if (QAbstractButton *q = qobject_cast<QAbstractButton *>(m_widgets[ PERS_UNDO ]))
@@ -609,8 +682,9 @@ void ScreenPersonality::nextFace(bool)
 
         if (WImage *q = qobject_cast<WImage *>(m_widgets[ VAL_FACELIFT ]))
         {
-            m_mugIdx = nextImageIdx(false, true);
-            q->setPixmap( ScreenCommon::getLargePortrait( m_mugIdx ) );
+            m_mugIdx = nextImageIdx(m_mugIdx, false, true);
+            q->setPixmap( getPortrait( m_mugIdx ) );
+            preloadPortraits();
         }
         // enable the Undo button now
         if (QAbstractButton *q = qobject_cast<QAbstractButton *>(m_widgets[ PERS_UNDO ]))
@@ -628,8 +702,9 @@ void ScreenPersonality::prevFace(bool)
 
         if (WImage *q = qobject_cast<WImage *>(m_widgets[ VAL_FACELIFT ]))
         {
-            m_mugIdx = nextImageIdx(false, false);
-            q->setPixmap( ScreenCommon::getLargePortrait( m_mugIdx ) );
+            m_mugIdx = nextImageIdx(m_mugIdx, false, false);
+            q->setPixmap( getPortrait( m_mugIdx ) );
+            preloadPortraits();
         }
         // enable the Undo button now
         if (QAbstractButton *q = qobject_cast<QAbstractButton *>(m_widgets[ PERS_UNDO ]))
@@ -1039,6 +1114,8 @@ void ScreenPersonality::portraitPopup(QPoint point)
 
         menu.addAction(m_cmPortraitModify);
         menu.addAction(m_cmPortraitReset);
+        menu.addSeparator();
+        menu.addAction(m_cmPortraitImport);
 
         menu.exec( point );
     }
@@ -1058,6 +1135,9 @@ void ScreenPersonality::cmPortraitModify()
         {
             q->setPixmap( ScreenCommon::getLargePortrait( m_mugIdx ) );
         }
+        // The replaced picture mustn't be served from the preload
+        m_portraitPreload.remove( m_mugIdx );
+
         emit changedPortrait();
     }
 }
@@ -1072,5 +1152,103 @@ void ScreenPersonality::cmPortraitReset()
     {
         q->setPixmap( ScreenCommon::getLargePortrait( m_mugIdx ) );
     }
+    // The replaced picture mustn't be served from the preload
+    m_portraitPreload.remove( m_mugIdx );
+
     emit changedPortrait();
 }
+
+void ScreenPersonality::cmPortraitImport()
+{
+    QString folder = ::getExistingDirectory( this, QObject::tr("Select folder of portrait images"), QDir::homePath() );
+
+    if (folder.isEmpty())
+        return;
+
+    // Images are matched to portraits by name, eg. "hummf.png" or "Lhummf.png"
+    QMap<int, QString> portraits;
+    QMap<int, qint64>  portraitAreas;
+    QStringList        unmatched;
+    QStringList        duplicates;
+
+    QDirIterator it( folder, QStringList() << "*.png" << "*.pnm" << "*.jpg" << "*.xpm", QDir::Files );
+    while (it.hasNext())
+    {
+        QString file = it.next();
+        QChar   prefix;
+        int     idx  = ScreenCommon::getPortraitIndexFromName( file, &prefix );
+
+        if (idx == -1)
+        {
+            unmatched << it.fileName();
+            continue;
+        }
+
+        // Packs often have the small, medium and large versions of a
+        // portrait side by side, and they all match the same one. The
+        // largest image is the one to scale the others down from, and if
+        // two are the same size the unprefixed or 'L' one wins, rather
+        // than whichever the directory listing happens to give last.
+        QSize  size = QImageReader( file ).size();
+        qint64 area = (qint64)qMax( size.width(), 0 ) * qMax( size.height(), 0 );
+        bool   large = prefix.isNull() || (prefix == 'L');
+
+        area = area * 2 + (large ? 1 : 0);
+
+        if (portraits.contains( idx ))
+        {
+            if (area > portraitAreas[ idx ])
+            {
+                duplicates << QFileInfo( portraits[ idx ] ).fileName();
+            }
+            else
+            {
+                duplicates << it.fileName();
+                continue;
+            }
+        }
+        portraits[ idx ]     = file;
+        portraitAreas[ idx ] = area;
+    }
+
+    if (portraits.isEmpty())
+    {
+        QMessageBox::warning( this, tr("Import portraits"), tr("None of the images in that folder are named after a portrait.") );
+        return;
+    }
+
+    int replaced = ::importPortraits( portraits, this );
+
+    if (replaced > 0)
+    {
+        // None of the preloaded pictures can be trusted now
+        m_portraitPreload.clear();
+
+        m_cmPortraitReset->setEnabled( ScreenCommon::isCustomPortrait( m_mugIdx ) );
+
+        if (WImage *q = qobject_cast<WImage *>(m_widgets[ VAL_FACELIFT ]))
+        {
+            q->setPixmap( ScreenCommon::getLargePortrait( m_mugIdx ) );
+        }
+        preloadPortraits();
+
+        emit changedPortrait();
+    }
+
+    QString details;
+
+    if (! duplicates.isEmpty())
+        details += tr("Smaller duplicates not used:") + "\n  " + duplicates.join( "\n  " ) + "\n";
+    if (! unmatched.isEmpty())
+        details += tr("Not named after a portrait:") + "\n  " + unmatched.join( "\n  " ) + "\n";
+
+    QMessageBox msgBox( QMessageBox::Information, tr("Import portraits"),
+                        tr("%n portrait(s) replaced.", "", replaced), QMessageBox::Ok, this );
+
+    if (! details.isEmpty())
+    {
+        msgBox.setInformativeText( tr("%n image(s) in the folder were not used.", "", duplicates.size() + unmatched.size()) );
+        msgBox.setDetailedText( details );
+    }
+    msgBox.exec();
+}
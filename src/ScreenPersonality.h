@@ -28,6 +28,9 @@
 
 #include <QWidget>
 #include <QAudioProbe>
+#include <QFuture>
+#include <QHash>
+#include <QImage>
 #include <QMediaPlayer>
 #include <QPixmap>
 #include <QPushButton>
@@ -74,6 +77,7 @@ public slots:
     void        portraitPopup(QPoint point);
     void        cmPortraitModify();
     void        cmPortraitReset();
+    void        cmPortraitImport();
     void        resetLanguage();
 
 protected:
@@ -84,7 +88,10 @@ private:
 
     void        resetScreen(void *char_tag, void *party_tag) override;
 
-    int         nextImageIdx(bool race, bool up);
+    int         nextImageIdx(int mugIdx, bool race, bool up);
+
+    QPixmap     getPortrait(int portraitIdx);
+    void        preloadPortraits();
 
     void        assemblePortraitIndices();
 
@@ -102,7 +109,11 @@ private:
  
     QAction          *m_cmPortraitModify;
     QAction          *m_cmPortraitReset;
+    QAction          *m_cmPortraitImport;
 
     QVector<int>      m_portraits[ PORTRAIT_GRP_SIZE];
+
+    // Portraits either side of m_mugIdx, being (or already) decoded in the background
+    QHash<int, QFuture<QImage> >  m_portraitPreload;
 };
 #endif
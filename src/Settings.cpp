@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2026 Anonymous Idiot
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Settings.h"
+
+#include <QSettings>
+#include <QStringList>
+#include <QTextCodec>
+
+#include <QDebug>
+
+Settings::Settings() :
+    QObject(),
+    m_codec(NULL)
+{
+    QSettings                  settings;
+    QHash<QString, QVariant>  *snapshot = new QHash<QString, QVariant>();
+
+    QStringList keys = settings.allKeys();
+
+    for (int k=0; k<keys.size(); k++)
+    {
+        snapshot->insert( keys[k], settings.value( keys[k] ) );
+    }
+
+    updateCodec( snapshot );
+
+    m_snapshot.store( snapshot, std::memory_order_release );
+}
+
+Settings::~Settings()
+{
+    delete m_snapshot.load();
+
+    qDeleteAll( m_retired );
+    m_retired.clear();
+}
+
+QVariant Settings::value( const QString &key, const QVariant &defaultValue ) const
+{
+    return m_snapshot.load( std::memory_order_acquire )->value( key, defaultValue );
+}
+
+bool Settings::contains( const QString &key ) const
+{
+    return m_snapshot.load( std::memory_order_acquire )->contains( key );
+}
+
+bool Settings::getBool( const QString &key ) const
+{
+    QVariant v = value( key );
+
+    if (v.isNull())
+        return false;
+
+    return v.toBool();
+}
+
+void Settings::setValue( const QString &key, const QVariant &value )
+{
+    m_write_lock.lock();
+
+    const QHash<QString, QVariant> *current = m_snapshot.load( std::memory_order_acquire );
+
+    if (current->contains( key ) && (current->value( key ) == value))
+    {
+        // Nothing changed; don't bother the disk or anybody listening
+        m_write_lock.unlock();
+        return;
+    }
+
+    QSettings settings;
+
+    settings.setValue( key, value );
+
+    QHash<QString, QVariant> *snapshot = new QHash<QString, QVariant>( *current );
+
+    snapshot->insert( key, value );
+
+    if (key == "Codepage")
+    {
+        updateCodec( snapshot );
+    }
+
+    m_snapshot.store( snapshot, std::memory_order_release );
+    m_retired << current;
+
+    m_write_lock.unlock();
+
+    emit valueChanged( key, value );
+}
+
+void Settings::updateCodec( const QHash<QString, QVariant> *snapshot )
+{
+    QByteArray  codepage = snapshot->value( "Codepage" ).toString().toLatin1();
+    QTextCodec *codec    = NULL;
+
+    if (!codepage.isEmpty() && (codepage != "UTF16LE"))
+    {
+        codec = QTextCodec::codecForName( codepage.constData() );
+
+        if (codec == NULL)
+        {
+            qWarning() << "Unknown codepage" << codepage << "- strings will be treated as unencoded";
+        }
+    }
+
+    m_codec.store( codec, std::memory_order_release );
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 Anonymous Idiot
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SETTINGS_H__
+#define SETTINGS_H__
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QVariant>
+
+#include <atomic>
+
+class QTextCodec;
+
+// In-memory snapshot of everything in QSettings.
+//
+// Constructing a QSettings object on linux parses the INI file from disk
+// every time, and a number of places (string decoding, the items list,
+// warning dialogs) were doing that on every call. Instead the whole lot is
+// read once here, and QSettings is only used to persist changes.
+//
+// Readers never take a lock: the current snapshot is an immutable hash that
+// gets replaced wholesale when a value is changed. Replaced snapshots are
+// kept until the app exits rather than freed, because a reader on another
+// thread may still be holding one - settings changes are rare enough that
+// this costs nothing worth worrying about.
+
+class Settings : public QObject
+{
+    Q_OBJECT
+
+protected:
+    Settings();
+    ~Settings();
+
+public:
+    // block cloning and assignment
+    Settings(Settings &other) = delete;
+    void operator=(const Settings &) = delete;
+
+    static Settings *getSettings()
+    {
+        // Initialisation of a function local static is thread safe, and
+        // after that this is just a load
+        static Settings *singleton = new Settings();
+
+        return singleton;
+    }
+
+    QVariant           value( const QString &key, const QVariant &defaultValue = QVariant() ) const;
+    bool               getBool( const QString &key ) const;
+    bool               contains( const QString &key ) const;
+
+    void               setValue( const QString &key, const QVariant &value );
+
+    // The codec for the "Codepage" setting, resolved once each time the
+    // setting changes instead of by name on every string decoded.
+    // Returns NULL for UTF16LE (or an unknown codepage), in which case text
+    // should be treated as raw 8 or 16 bit characters.
+    QTextCodec        *getCodec() const { return m_codec.load( std::memory_order_acquire ); }
+
+signals:
+    void               valueChanged( const QString &key, const QVariant &value );
+
+private:
+    void               updateCodec( const QHash<QString, QVariant> *snapshot );
+
+    std::atomic<const QHash<QString, QVariant> *>   m_snapshot;
+    QList<const QHash<QString, QVariant> *>          m_retired;
+    QMutex                                           m_write_lock;
+
+    std::atomic<QTextCodec *>                        m_codec;
+};
+
+#endif // SETTINGS_H__
@@ -26,10 +26,15 @@
 #include "StringList.h"
 #include "Localisation.h"
 #include "SLFFile.h"
+#include "common.h"
 
 #include <QTextCodec>
 #include <QDebug>
 
+#ifdef __SSE2__
+ #include <emmintrin.h>
+#endif
+
 // This app was written to use the the strings from the app where
 // possible. Then I found the Grey Tiefing mod and realised that
 // if I loaded it the entire interface now came up in Russian as
@@ -60,18 +65,44 @@ StringList::StringList( QString filename, bool force_base )
 
     if (strings.open(QFile::ReadOnly))
     {
-        quint32 num_strings = strings.readLEULong();
+        // Only the offset table is built here. Most of the several thousand
+        // strings are for screens that never get opened in a session, so
+        // the deciphering and codepage conversion is deferred until
+        // getString() actually asks for one.
+        strings.readAll( m_cipherText );
+        strings.close();
 
-        for (quint32 k = 0; k < num_strings; k++)
+        const quint8 *buf   = (const quint8 *)m_cipherText.constData();
+        quint32       size  = (quint32)m_cipherText.size();
+
+        if (size >= 4)
         {
-            quint32 str_sz = strings.readLEULong();
+            quint32 num_strings = FORMAT_LE32(buf);
+            quint32 offset      = 4;
+
+            // Every string takes at least its 4 byte length
+            m_offsets.reserve( qMin( num_strings, size / 4 ) );
+
+            for (quint32 k = 0; k < num_strings; k++)
+            {
+                if (offset + 4 > size)
+                    break;
+
+                quint32 str_sz = FORMAT_LE32(buf + offset);
+
+                // offset + 4 <= size from above, so this can't wrap the
+                // way adding a corrupt str_sz on to the offset could
+                if (str_sz > size - offset - 4)
+                    break;
 
-            QByteArray s = strings.read( str_sz );
+                m_offsets << offset;
 
-            m_strings << decipher( s );
+                offset += 4 + str_sz;
+            }
         }
 
-        strings.close();
+        m_strings.resize( m_offsets.size() );
+        m_deciphered.resize( m_offsets.size() );
     }
 }
 
@@ -80,24 +111,54 @@ StringList::~StringList()
     m_strings.clear();
 }
 
+// 0x96 - byte, wrapping at 256. Operates on 16 bytes at a time where
+// SSE2 is available (it always is for our targets, see the .pro file)
+// so that bulk callers don't pay a per-byte cost.
+void StringList::decipher( quint8 *buf, int len )
+{
+    int k = 0;
+
+#ifdef __SSE2__
+    const __m128i key = _mm_set1_epi8( (char)0x96 );
+
+    for (; k + 16 <= len; k += 16)
+    {
+        __m128i v = _mm_loadu_si128( (const __m128i *)(buf + k) );
+
+        _mm_storeu_si128( (__m128i *)(buf + k), _mm_sub_epi8( key, v ) );
+    }
+#endif
+    for (; k < len; k++)
+    {
+        buf[k] = (quint8)(0x96 - buf[k]);
+    }
+}
+
 QString StringList::decipher( QByteArray in )
 {
     quint8 *dec = (quint8 *) in.data();
-    for (int k=0; k<in.size(); k++)
-    {
-        int idiotCypher = 0x96 - dec[k];
 
-        if (idiotCypher < 0)
-            idiotCypher += 256;
+    decipher( dec, in.size() );
 
-        dec[k] = idiotCypher;
-    }
     return Localisation::decode( (const char *)dec, in.size(), true );
 }
 
+const QString StringList::decipherString( int idx ) const
+{
+    if (! m_deciphered.testBit( idx ))
+    {
+        const quint8 *buf    = (const quint8 *)m_cipherText.constData() + m_offsets.at( idx );
+        quint32       str_sz = FORMAT_LE32(buf);
+
+        m_strings[ idx ] = decipher( QByteArray( (const char *)buf + 4, str_sz ) );
+        m_deciphered.setBit( idx );
+    }
+    return m_strings.at( idx );
+}
+
 bool StringList::isNull() const
 {
-    if (m_strings.size() > 0)
+    if (m_offsets.size() > 0)
         return false;
 
     return true;
@@ -105,14 +166,14 @@ bool StringList::isNull() const
 
 int StringList::getNumStrings() const
 {
-    return m_strings.size();
+    return m_offsets.size();
 }
 
 const QString StringList::getString( int idx ) const
 {
     int base_idx = idx & ~APPEND_COLON;
 
-    if ((base_idx > 0) && (base_idx < m_strings.size()))
+    if ((base_idx > 0) && (base_idx < m_offsets.size()))
     {
         Localisation *loc = Localisation::getLocalisation();
 
@@ -137,9 +198,9 @@ const QString StringList::getUnlocalisedString( int idx ) const
 
     int base_idx = idx & ~APPEND_COLON;
 
-    if ((base_idx > 0) && (base_idx < m_strings.size()))
+    if ((base_idx > 0) && (base_idx < m_offsets.size()))
     {
-        s = m_strings.at( base_idx );
+        s = decipherString( base_idx );
     }
     else if (base_idx > 5000)
     {
@@ -311,6 +372,18 @@ const QString StringList::getUnlocalisedString( int idx ) const
             case Stackable:
                 s = QObject::tr("Stackable");
                 break;
+            case Search:
+                s = QObject::tr("Search");
+                break;
+            case Filter:
+                s = QObject::tr("Filter");
+                break;
+            case FilterByType:
+                s = QObject::tr("Filter by Type");
+                break;
+            case Cursed:
+                s = QObject::tr("Cursed");
+                break;
 
             case OpenNavigator:
                 s = QObject::tr("Open Navigator");
@@ -26,8 +26,10 @@
 #ifndef STRINGLIST_H__
 #define STRINGLIST_H__
 
-#include <QList>
+#include <QBitArray>
+#include <QByteArray>
 #include <QString>
+#include <QVector>
 
 class Localisation;
 
@@ -120,6 +122,10 @@ public:
         FilterByGender         =  5502,
         Special                =  5503,
         Stackable              =  5504,
+        Search                 =  5505,
+        Filter                 =  5506,
+        FilterByType           =  5507,
+        Cursed                 =  5508,
 
         OpenNavigator          =  5600,
         Position               =  5601,
@@ -553,9 +559,19 @@ public:
     const QString     getString( int idx ) const;
 
     static QString    decipher( QByteArray in );
+    static void       decipher( quint8 *buf, int len );
 
 private:
-    QList<QString>    m_strings;
+    // The raw (still ciphered) string table as read from the SLF, and
+    // the offset of each string's length prefix within it. Strings are
+    // only deciphered the first time somebody asks for them.
+    QByteArray                 m_cipherText;
+    QVector<quint32>           m_offsets;
+
+    mutable QVector<QString>   m_strings;
+    mutable QBitArray          m_deciphered;
+
+    const QString     decipherString( int idx ) const;
 
     const QString     getUnlocalisedString( int idx ) const;
 };
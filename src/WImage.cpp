@@ -27,6 +27,7 @@
 #include <QByteArray>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QPixmapCache>
 
 #include "WImage.h"
 
@@ -141,6 +142,9 @@ WImage::WImage(QString file, int image_idx, QColor transparentColor, double extr
 
     QBitmap mask = m_pixmap.createMaskFromColor( transparentColor, Qt::MaskInColor );
     m_pixmap.setMask( mask );
+
+    if (! m_sourceFile.isEmpty())
+        m_sourceColour = transparentColor.name();
 }
 
 WImage::WImage(QPixmap &pix, QWidget* parent, Qt::WindowFlags)
@@ -204,7 +208,7 @@ void WImage::setStiFile(QString sti_file, int image_idx, bool keep)
         m_stiImages = new STI( m_stiData );
         m_frameIdx  = image_idx;
 
-        this->setPixmap( QPixmap::fromImage( m_stiImages->getImage( image_idx )) );
+        setSourcePixmap( QPixmap::fromImage( m_stiImages->getImage( image_idx )), sti_file.toUpper(), image_idx );
         if (! keep)
         {
             delete m_stiImages;
@@ -229,7 +233,7 @@ void WImage::setTargaFile(QString tga_file)
 
         TGAtoQImage tgaImage( imgs.readAll() );
 
-        this->setPixmap( QPixmap::fromImage( tgaImage.getImage()) );
+        setSourcePixmap( QPixmap::fromImage( tgaImage.getImage()), tga_file.toUpper(), 0 );
 
         imgs.close();
     }
@@ -245,7 +249,7 @@ void WImage::setImageFile(QString img_file, const char *extension)
         QImage     m;
 
         m.loadFromData( imgs.readAll(), extension );
-        this->setPixmap( QPixmap::fromImage( m ) );
+        setSourcePixmap( QPixmap::fromImage( m ), img_file.toUpper(), 0 );
 
         imgs.close();
 
@@ -265,17 +269,94 @@ void WImage::animate()
         if (m_frameIdx >= maxFrame)
             m_frameIdx = 0;
 
-        this->setPixmap( QPixmap::fromImage( m_stiImages->getImage( m_frameIdx )) );
+        // Frames after the first never get the transparent colour masked
+        // out, so setSourcePixmap() dropping m_sourceColour is correct here
+        setSourcePixmap( QPixmap::fromImage( m_stiImages->getImage( m_frameIdx )), m_sourceFile, m_frameIdx );
     }
 }
 
 void WImage::setPixmap(QPixmap pixmap)
 {
-    m_pixmap = pixmap;
+    // Pixmaps handed to us by the caller could be anything, so these only
+    // share derived images with other copies of the same QPixmap
+    setSourcePixmap( pixmap, QString(), 0 );
+}
+
+void WImage::setSourcePixmap(const QPixmap &pixmap, const QString &sourceFile, int frame)
+{
+    m_pixmap       = pixmap;
+    m_sourceFile   = sourceFile;
+    m_sourceFrame  = frame;
+    m_sourceColour = QString();
+
     resize( m_scale * m_pixmap.width(), m_scale * m_pixmap.height() );
     update();
 }
 
+// Scaling with smooth transformation, and converting to greyscale for
+// disabled widgets, are by far the most expensive parts of a paint, and
+// screens like the skills and attributes have dozens of these that never
+// change. So the result is kept, both on the widget itself and in the
+// global QPixmapCache so that other WImages showing the same frame at the
+// same size don't have to redo it either.
+QPixmap WImage::getDerivedPixmap(const QSize &target, const QRect &crop)
+{
+    qreal    dpr    = devicePixelRatioF();
+    QSize    size   = target * dpr;
+    QString  source;
+
+    if (m_sourceFile.isEmpty())
+    {
+        source = QString("#%1").arg( m_pixmap.cacheKey() );
+    }
+    else
+    {
+        // The same file name can resolve to different images depending on
+        // which parallel world is loaded, so that is part of the key too
+        source = QString("%1|%2#%3|%4")
+                     .arg( SLFFile::getParallelWorldPath() )
+                     .arg( m_sourceFile )
+                     .arg( m_sourceFrame )
+                     .arg( m_sourceColour );
+    }
+
+    QString  key = QString("WImage:%1:%2x%3:%4,%5,%6,%7:%8")
+                       .arg( source )
+                       .arg( size.width() ).arg( size.height() )
+                       .arg( crop.x() ).arg( crop.y() ).arg( crop.width() ).arg( crop.height() )
+                       .arg( this->isEnabled() ? "E" : "D" );
+
+    if (key == m_derivedKey)
+        return m_derived;
+
+    QPixmap pic;
+
+    if (! QPixmapCache::find( key, &pic ))
+    {
+        pic = crop.isNull() ? m_pixmap : m_pixmap.copy( crop );
+
+        // Grayscale disabled images
+        if (! this->isEnabled())
+        {
+            QImage s = pic.toImage();
+            pic = QPixmap::fromImage( s.convertToFormat( QImage::Format_Grayscale8 ) );
+        }
+
+        if (pic.size() != size)
+        {
+            pic = pic.scaled( size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation );
+        }
+
+        QPixmapCache::insert( key, pic );
+    }
+    pic.setDevicePixelRatio( dpr );
+
+    m_derived    = pic;
+    m_derivedKey = key;
+
+    return m_derived;
+}
+
 QSize WImage::getPixmapSize() const
 {
     return m_pixmap.size();
@@ -310,30 +391,16 @@ void WImage::paintEvent(QPaintEvent *)
 {
     QPainter painter(this);
 
-    // Make the upscaling look nicer
-    painter.setRenderHint( QPainter::Antialiasing,          true );
-    painter.setRenderHint( QPainter::TextAntialiasing,      true );
-    painter.setRenderHint( QPainter::SmoothPixmapTransform, true );
+    if (m_pixmap.isNull())
+        return;
 
-    QPixmap pic = m_pixmap;
-
-    // Grayscale disabled images
-    if (! this->isEnabled())
-    {
-        QImage s = pic.toImage();
-        pic = QPixmap::fromImage( s.convertToFormat( QImage::Format_Grayscale8 ) );
-    }
+    // Only matters if the derived pixmap's size gets rounded differently
+    // to the target on high DPI screens
+    painter.setRenderHint( QPainter::SmoothPixmapTransform, true );
 
     if ((m_xScale == 1.0) && (m_yScale == 1.0) && (m_extraScale == 1.0))
     {
-        if (m_crop.isNull())
-        {
-            painter.drawPixmap( rect(), pic);
-        }
-        else
-        {
-            painter.drawPixmap( rect(), pic, m_crop);
-        }
+        painter.drawPixmap( rect(), getDerivedPixmap( rect().size(), m_crop ) );
     }
     else
     {
@@ -352,7 +419,9 @@ void WImage::paintEvent(QPaintEvent *)
         if (m_anchor & Qt::AlignBottom)
             y_pos += rect().height() * (1.0 - m_yScale);
 
-        painter.drawPixmap( x_pos, y_pos, rect().width()*m_xScale * m_extraScale, rect().height()*m_yScale * m_extraScale, pic);
+        QRect target( x_pos, y_pos, rect().width()*m_xScale * m_extraScale, rect().height()*m_yScale * m_extraScale );
+
+        painter.drawPixmap( target, getDerivedPixmap( target.size(), QRect() ) );
     }
 }
 
@@ -78,7 +78,22 @@ protected:
 
 
 private:
+    void           setSourcePixmap(const QPixmap &pixmap, const QString &sourceFile, int frame);
+    QPixmap        getDerivedPixmap(const QSize &target, const QRect &crop);
+
     QPixmap        m_pixmap;
+
+    // Where m_pixmap came from, used to key the derived pixmap cache. An
+    // empty m_sourceFile means a caller supplied pixmap.
+    QString        m_sourceFile;
+    int            m_sourceFrame;
+    QString        m_sourceColour;
+
+    // The scaled (and greyscaled when disabled) version of m_pixmap last
+    // painted, so that a repaint is a straight blit.
+    QPixmap        m_derived;
+    QString        m_derivedKey;
+
     Qt::Alignment  m_anchor;
     double         m_xScale;
     double         m_yScale;
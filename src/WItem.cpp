@@ -37,6 +37,7 @@
 #include "WItem.h"
 
 #include "main.h"
+#include "ItemIconAtlas.h"
 #include "SLFFile.h"
 #include "STI.h"
 
@@ -140,23 +141,15 @@ void WItem::resetPixmaps()
     }
     else
     {
-        SLFFile imgs( "ITEMS/" + m_item.getStiFile().toUpper() );
+        int frame = kBackpackItemIndex;
 
-        if (imgs.open(QFile::ReadOnly))
-        {
-            QByteArray array;
-
-            imgs.readAll( array );
-            STI sti_imgs( array );
+        // Wearable items have more height (different aspect ratio)
+        if (m_rect.height() > kBackpackItemMaxHeight)
+            frame = kExtendedItemIndex;
 
-            if (m_rect.height() <= kBackpackItemMaxHeight)
-                m_itemPixmap = QPixmap::fromImage( sti_imgs.getImage( kBackpackItemIndex ));
-            else // Wearable item, which has more height (different aspect ratio)
-                m_itemPixmap = QPixmap::fromImage( sti_imgs.getImage( kExtendedItemIndex ));
+        m_itemPixmap = ItemIconAtlas::getAtlas()->getItemIcon( m_item.getId(), frame );
 
-            imgs.close();
-        }
-        else
+        if (m_itemPixmap.isNull())
         {
             // The item lacks an image - some mods have this problem; use our
             // generic replacement icon
@@ -27,18 +27,19 @@
 
 #include "WindowFactEditor.h"
 
+#include "FactsTableModel.h"
 #include "SLFFile.h"
 #include "main.h"
 
 #include <QHeaderView>
 #include <QPainter>
 #include <QPixmap>
-#include <QTableWidget>
-#include <QTableWidgetItem>
+#include <QTableView>
 
 #include "WButton.h"
 #include "WImage.h"
 #include "WLabel.h"
+#include "WLineEdit.h"
 #include "WScrollBar.h"
 
 #include <QDebug>
@@ -49,6 +50,7 @@ typedef enum
 
     FACTS_SCROLLLIST,
     FACTS_SCROLLBAR,
+    FACTS_FILTER,
 
     SIZE_WIDGET_IDS
 } widget_ids;
@@ -59,6 +61,12 @@ WindowFactEditor::WindowFactEditor(facts &f)
     Wizardry8Scalable(::getAppScale()),
     m_facts(f)
 {
+    // Nothing is copied into the view; rows are drawn straight from the
+    // facts as they scroll into view
+    m_model = new FactsTableModel( m_facts, this );
+    m_proxy = new FactsFilterProxyModel( this );
+    m_proxy->setSourceModel( m_model );
+
     QPixmap bgImg = makeDialogForm();
 
     m_bgImgSize = bgImg.size();
@@ -73,7 +81,10 @@ WindowFactEditor::WindowFactEditor(facts &f)
         { NO_ID,              QRect(  10,  32,  70,  12 ),    new WLabel( tr("Facts:"), Qt::AlignRight, 10, QFont::Thin,                     this ),  -1,  NULL },
 
         { FACTS_SCROLLBAR,    QRect( 504,  30,  15, 225 ),    new WScrollBar( Qt::Orientation::Vertical,                                     this ),  -1,  NULL },
-        { FACTS_SCROLLLIST,   QRect(  88,  29, 402, 226 ),    new QTableWidget(                                                    this ),  -1,  NULL },
+        { FACTS_SCROLLLIST,   QRect(  88,  29, 402, 226 ),    new QTableView(                                                      this ),  -1,  NULL },
+
+        { NO_ID,              QRect(  10, 272,  70,  12 ),    new WLabel( StringList::Filter + StringList::APPEND_COLON, Qt::AlignRight, 10, QFont::Thin,                    this ),  -1,  NULL },
+        { FACTS_FILTER,       QRect(  88, 270, 200,  16 ),    new WLineEdit( "",         Qt::AlignLeft,  10, QFont::Thin,                    this ),  -1,  SLOT(filterChanged(const QString &)) },
 
         { NO_ID,              QRect( 462, 268,  -1,  -1 ),    new WButton(   "DIALOGS/DIALOGCONFIRMATION.STI",               0, true, 1.0,   this ),  -1,  SLOT(apply(bool)) },
         { NO_ID,              QRect( 494, 268,  -1,  -1 ),    new WButton(   "DIALOGS/DIALOGCONFIRMATION.STI",               4, true, 1.0,   this ),  -1,  SLOT(close()) },
@@ -85,9 +96,9 @@ WindowFactEditor::WindowFactEditor(facts &f)
 
 
     // The fact list
-    if (QTableWidget *factlist = qobject_cast<QTableWidget *>(m_widgets[ FACTS_SCROLLLIST ] ))
+    if (QTableView *factlist = qobject_cast<QTableView *>(m_widgets[ FACTS_SCROLLLIST ] ))
     {
-        QStringList cols;
+        factlist->setModel( m_proxy );
 
         Q_ASSERT( factlist->horizontalHeader() );
         factlist->horizontalHeader()->setSectionsMovable( true );
@@ -95,12 +106,11 @@ WindowFactEditor::WindowFactEditor(facts &f)
         factlist->verticalHeader()->setVisible( false );
         factlist->setDragEnabled( false );
 
-        cols << "Enabled";
-        cols << "ID";
-        cols << "Name";
-        factlist->setColumnCount( cols.size() );
-        factlist->setHorizontalHeaderLabels( cols );
-        factlist->setColumnWidth( 2, 400 );
+        factlist->setColumnWidth( FactsTableModel::Name, 400 );
+
+        // Start off in fact order
+        factlist->horizontalHeader()->setSortIndicator( FactsTableModel::ID, Qt::AscendingOrder );
+        factlist->setSortingEnabled( true );
 
         if (WScrollBar *sb = qobject_cast<WScrollBar *>(m_widgets[ FACTS_SCROLLBAR ] ))
         {
@@ -120,8 +130,6 @@ WindowFactEditor::WindowFactEditor(facts &f)
         }
     }
 
-    updateList();
-
     this->setMinimumSize( m_bgImgSize * m_scale );
     this->setMaximumSize( m_bgImgSize * m_scale );
 
@@ -184,7 +192,7 @@ void WindowFactEditor::resizeEvent(QResizeEvent *event)
         {
             w->setScale( m_scale );
         }
-        else if (QTableWidget *q = qobject_cast<QTableWidget *>(widgets[k]))
+        else if (QTableView *q = qobject_cast<QTableView *>(widgets[k]))
         {
             // (  88,  29, 402, 226 )
             q->move( 88 * m_scale, 29 * m_scale );
@@ -239,73 +247,14 @@ QPixmap WindowFactEditor::makeDialogForm()
     return beginAgain;
 }
 
-void WindowFactEditor::updateList()
+void WindowFactEditor::filterChanged(const QString &text)
 {
-    // Repopulate the fact list
-    if (QTableWidget *factlist = qobject_cast<QTableWidget *>(m_widgets[ FACTS_SCROLLLIST ] ))
-    {
-        factlist->clearContents();
-
-        int num_items = m_facts.size();
-
-        factlist->setRowCount( num_items );
-        factlist->setSortingEnabled( false );
-
-        for (int k=0; k < num_items; k++)
-        {
-            QTableWidgetItem *w_set  = new QTableWidgetItem( " " );
-
-            w_set->setData( Qt::UserRole, k );
-
-            if (m_facts.getValue( k ))
-            {
-                w_set->setCheckState( Qt::Checked );
-            }
-            else
-            {
-                w_set->setCheckState( Qt::Unchecked );
-            }
-
-            QTableWidgetItem *w_id   = new QTableWidgetItem();
-            w_id->setData( Qt::DisplayRole, k ); // setting the contents of w_id this way, keeps it numeric (for sorting)
-
-            QTableWidgetItem *w_name = new QTableWidgetItem( m_facts.getKey( k ) );
-
-            Qt::ItemFlags flags = Qt::ItemIsEnabled; // non editable, draggable, dropable, selectable etc.
-
-            w_id->setFlags( flags );
-            w_name->setFlags( flags );
-            w_set->setFlags( flags | Qt::ItemIsUserCheckable );
-
-            w_id->setTextAlignment(   Qt::AlignRight | Qt::AlignVCenter ); // numeric field right aligned
-            w_name->setTextAlignment(  Qt::AlignLeft | Qt::AlignVCenter ); // text field left aligned
-            w_set->setTextAlignment( Qt::AlignCenter | Qt::AlignVCenter ); // checkbox field centre aligned
-
-            factlist->setItem( k, 0, w_set  );
-            factlist->setItem( k, 1, w_id   );
-            factlist->setItem( k, 2, w_name );
-        }
-        factlist->setSortingEnabled( true );
-    }
+    m_proxy->setNameFilter( text );
 }
 
 void WindowFactEditor::apply(bool)
 {
-    if (QTableWidget *factlist = qobject_cast<QTableWidget *>(m_widgets[ FACTS_SCROLLLIST ] ))
-    {
-        int num_items = m_facts.size();
-        for (int k=0; k < num_items; k++)
-        {
-            const QTableWidgetItem *w = factlist->item( k, 0 );
+    m_model->apply( m_facts );
 
-            Q_ASSERT(w);
-            QVariant v_id = w->data( Qt::UserRole );
-
-            if (v_id.isValid() && ! v_id.isNull())
-            {
-                m_facts.setValue( v_id.toInt(), (w->checkState() == Qt::Checked) );
-            }
-        }
-    }
     close();
 }
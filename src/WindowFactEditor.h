@@ -37,6 +37,9 @@
 
 #include "Wizardry8Scalable.h"
 
+class FactsTableModel;
+class FactsFilterProxyModel;
+
 class WindowFactEditor : public QWidget, public Wizardry8Scalable
 {
     Q_OBJECT
@@ -49,6 +52,7 @@ public:
 
 public slots:
     void apply(bool checked);
+    void filterChanged(const QString &text);
 
 signals:
     void windowClosing();
@@ -57,8 +61,6 @@ protected:
     void closeEvent(QCloseEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
 
-    void updateList();
-
 private:
     QPixmap     makeDialogForm();
 
@@ -66,6 +68,9 @@ private:
     QMap<int, QWidget *>   m_widgets;
 
     facts                 &m_facts;
+
+    FactsTableModel       *m_model;
+    FactsFilterProxyModel *m_proxy;
 };
 
 #endif
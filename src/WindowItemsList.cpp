@@ -27,17 +27,25 @@
 #include <QCloseEvent>
 #include <QHeaderView>
 #include <QMenu>
-#include <QSettings>
+#include <QTableView>
 
 #include "WindowItemsList.h"
 
+#include "ItemFilter.h"
+#include "ItemSearchIndex.h"
+#include "ItemsTableModel.h"
 #include "SLFFile.h"
+#include "Settings.h"
 #include "STI.h"
+#include "dbHelper.h"
 #include "main.h"
 
 #include <QListWidgetItem>
 #include <QPainter>
 #include <QPixmap>
+#include <QBitArray>
+
+#include <algorithm>
 
 #include "Screen.h"
 #include "DialogChooseColumns.h"
@@ -48,9 +56,9 @@
 #include "WImage.h"
 #include "WItem.h"
 #include "WLabel.h"
+#include "WLineEdit.h"
 #include "WScrollBar.h"
-#include "WTableWidget.h"
-#include "WTableWidgetItem.h"
+#include "WSpinBox.h"
 
 #include "spell.h"
 
@@ -63,16 +71,64 @@ typedef enum
     CB_FILTER_BY_PROF,
     CB_FILTER_BY_RACE,
     CB_FILTER_BY_SEX,
+    CB_FILTER_BY_TYPE,
 
     DDL_PROFS,
     DDL_RACES,
     DDL_GENDERS,
+    DDL_TYPES,
+
+    VAL_SEARCH,
+
+    CB_TWO_HANDED,
+    CB_CURSED,
+    CB_SPECIAL,
+
+    VAL_WEIGHT_MIN,
+    VAL_WEIGHT_MAX,
+    VAL_PRICE_MIN,
+    VAL_PRICE_MAX,
+    VAL_AC_MIN,
+    VAL_AC_MAX,
 
     TABLE_ITEMS,
 
     SIZE_WIDGET_IDS
 } widget_ids;
 
+template <typename T> static void columnRange(const QVector<T> &column, int *min, int *max)
+{
+    *min = 0;
+    *max = 0;
+
+    if (! column.isEmpty())
+    {
+        *min = *std::min_element( column.constBegin(), column.constEnd() );
+        *max = *std::max_element( column.constBegin(), column.constEnd() );
+    }
+}
+
+static bool isChecked(QWidget *w)
+{
+    if (WCheckBox *cb = qobject_cast<WCheckBox *>(w))
+        return cb->checkState() == Qt::Checked;
+
+    return false;
+}
+
+// Range controls left at their full extent don't filter anything, so
+// don't cost a pass over the column either
+static void applyRange(ItemFilter &allowed, ItemFilter::field f, QWidget *minWidget, QWidget *maxWidget, int unit)
+{
+    WSpinBox *lo = qobject_cast<WSpinBox *>(minWidget);
+    WSpinBox *hi = qobject_cast<WSpinBox *>(maxWidget);
+
+    if (lo && hi && ((lo->value() > lo->minimum()) || (hi->value() < hi->maximum())))
+    {
+        allowed &= ItemFilter::inRange( f, (qint64)lo->value() * unit, (qint64)hi->value() * unit + unit - 1 );
+    }
+}
+
 
 WindowItemsList::WindowItemsList(character::profession profession, character::race race, character::gender gender)
     : QWidget(),
@@ -80,8 +136,15 @@ WindowItemsList::WindowItemsList(character::profession profession, character::ra
     m_prof_filter(profession),
     m_race_filter(race),
     m_gender_filter(gender),
+    m_type_filter(-1),
     m_contextMenu(NULL)
 {
+    // The model holds every item, and the proxy does the filtering and
+    // sorting, so changing the filters never rebuilds any of the cells
+    m_model = new ItemsTableModel( this );
+    m_proxy = new ItemsFilterProxyModel( this );
+    m_proxy->setSourceModel( m_model );
+
     QPixmap controlsBg = makeDialogForm();
 
     // Tile the background image that was loaded as part of making the controlBg
@@ -96,6 +159,19 @@ WindowItemsList::WindowItemsList(character::profession profession, character::ra
     setBackgroundRole( QPalette::Window );
     setPalette( pal );
 
+    // The range controls start out covering every item in the database
+    const itemColumns &columns = dbHelper::getHelper()->getItemColumns();
+
+    int minWeight, maxWeight, minPrice, maxPrice, minAC, maxAC;
+
+    columnRange( columns.weight, &minWeight, &maxWeight );
+    columnRange( columns.price,  &minPrice,  &maxPrice );
+    columnRange( columns.ac,     &minAC,     &maxAC );
+
+    // Weights are in tenths of a pound in the database, but whole pounds here
+    minWeight = minWeight / 10;
+    maxWeight = (maxWeight + 9) / 10;
+
     // All these controls are added as children of this widget, and hence will be destructed automatically
     // when we are destroyed
 
@@ -103,14 +179,33 @@ WindowItemsList::WindowItemsList(character::profession profession, character::ra
     {
         { NO_ID,              QRect(   0,   0,  -1,  -1 ),    new WImage(    controlsBg,                                                        this ),  -1,  NULL },
 
-        { TABLE_ITEMS,        QRect(  10, 145, 400, 200 ),    new WTableWidget( this ), -1, NULL },
+        { TABLE_ITEMS,        QRect(  10, 290, 400, 200 ),    new QTableView( this ),  -1, NULL },
 
         { CB_FILTER_BY_PROF,  QRect(  20,  19, 140,  13 ),    new WCheckBox( StringList::FilterByProfession + StringList::APPEND_COLON,         this ),  -1,  SLOT(filterProf(int)) },
         { CB_FILTER_BY_RACE,  QRect(  20,  60, 140,  13 ),    new WCheckBox( StringList::FilterByRace + StringList::APPEND_COLON,               this ),  -1,  SLOT(filterRace(int)) },
         { CB_FILTER_BY_SEX,   QRect(  20, 101, 140,  13 ),    new WCheckBox( StringList::FilterByGender + StringList::APPEND_COLON,             this ),  -1,  SLOT(filterSex(int)) },
+        { CB_FILTER_BY_TYPE,  QRect(  20, 142, 140,  13 ),    new WCheckBox( StringList::FilterByType + StringList::APPEND_COLON,               this ),  -1,  SLOT(filterType(int)) },
+
+        { NO_ID,              QRect(  20, 175, 140,  13 ),    new WLabel(    StringList::Search + StringList::APPEND_COLON, Qt::AlignLeft,  10, QFont::Thin,       this ),  -1,  NULL },
+        { VAL_SEARCH,         QRect( 169, 173, 195,  16 ),    new WLineEdit( "",                          Qt::AlignLeft,  10, QFont::Thin,       this ),  -1,  SLOT(searchChanged(const QString &)) },
+
+        { CB_TWO_HANDED,      QRect(  20, 198, 140,  13 ),    new WCheckBox( StringList::TwoHandedWeapon,                                        this ),  -1,  SLOT(filterChanged(int)) },
+        { CB_CURSED,          QRect( 169, 198,  90,  13 ),    new WCheckBox( StringList::Cursed,                                                 this ),  -1,  SLOT(filterChanged(int)) },
+        { CB_SPECIAL,         QRect( 274, 198,  90,  13 ),    new WCheckBox( StringList::Special,                                                this ),  -1,  SLOT(filterChanged(int)) },
+
+        { NO_ID,              QRect(  20, 220, 140,  13 ),    new WLabel(    StringList::Weight + StringList::APPEND_COLON, Qt::AlignLeft,  10, QFont::Thin,       this ),  -1,  NULL },
+        { VAL_WEIGHT_MIN,     QRect( 169, 220,  90,  13 ),    new WSpinBox(  minWeight, minWeight, maxWeight,                                    this ),  -1,  SLOT(filterChanged(int)) },
+        { VAL_WEIGHT_MAX,     QRect( 274, 220,  90,  13 ),    new WSpinBox(  maxWeight, minWeight, maxWeight,                                    this ),  -1,  SLOT(filterChanged(int)) },
+        { NO_ID,              QRect(  20, 242, 140,  13 ),    new WLabel(    StringList::Value + StringList::APPEND_COLON,  Qt::AlignLeft,  10, QFont::Thin,       this ),  -1,  NULL },
+        { VAL_PRICE_MIN,      QRect( 169, 242,  90,  13 ),    new WSpinBox(  minPrice,  minPrice,  maxPrice,                                     this ),  -1,  SLOT(filterChanged(int)) },
+        { VAL_PRICE_MAX,      QRect( 274, 242,  90,  13 ),    new WSpinBox(  maxPrice,  minPrice,  maxPrice,                                     this ),  -1,  SLOT(filterChanged(int)) },
+        { NO_ID,              QRect(  20, 264, 140,  13 ),    new WLabel(    StringList::AC + StringList::APPEND_COLON,     Qt::AlignLeft,  10, QFont::Thin,       this ),  -1,  NULL },
+        { VAL_AC_MIN,         QRect( 169, 264,  90,  13 ),    new WSpinBox(  minAC,     minAC,     maxAC,                                        this ),  -1,  SLOT(filterChanged(int)) },
+        { VAL_AC_MAX,         QRect( 274, 264,  90,  13 ),    new WSpinBox(  maxAC,     minAC,     maxAC,                                        this ),  -1,  SLOT(filterChanged(int)) },
 
         // Do these in reverse order because each drop down list obscures the one below it, and they need to
         // be on top to do it.
+        { DDL_TYPES,          QRect( 169, 135,  -1,  -1 ),    new WDDL(      "Lucida Calligraphy",        Qt::AlignLeft,  9, QFont::Thin,       this ),  -1,  SLOT(ddlChanged(int)) },
         { DDL_GENDERS,        QRect( 169,  94,  -1,  -1 ),    new WDDL(      "Lucida Calligraphy",        Qt::AlignLeft,  9, QFont::Thin,       this ),  -1,  SLOT(ddlChanged(int)) },
         { DDL_RACES,          QRect( 169,  53,  -1,  -1 ),    new WDDL(      "Lucida Calligraphy",        Qt::AlignLeft,  9, QFont::Thin,       this ),  -1,  SLOT(ddlChanged(int)) },
         { DDL_PROFS,          QRect( 169,  12,  -1,  -1 ),    new WDDL(      "Lucida Calligraphy",        Qt::AlignLeft,  9, QFont::Thin,       this ),  -1,  SLOT(ddlChanged(int)) },
@@ -190,9 +285,21 @@ WindowItemsList::WindowItemsList(character::profession profession, character::ra
         }
         q->updateList();
     }
+    if (WDDL *q = qobject_cast<WDDL *>(m_widgets[ DDL_TYPES ]))
+    {
+        populateDDLTypes( q );
+
+        connect( q, SIGNAL(listActive()), this, SLOT(ddlActive()) );
+        q->updateList();
+
+        // The type filter always starts off
+        q->setEnabled( false );
+    }
 
-    if (QTableWidget *q = qobject_cast<QTableWidget *>(m_widgets[ TABLE_ITEMS ]))
+    if (QTableView *q = qobject_cast<QTableView *>(m_widgets[ TABLE_ITEMS ]))
     {
+        q->setModel( m_proxy );
+
         Q_ASSERT( q->horizontalHeader() );
         q->horizontalHeader()->setSectionsMovable( true );
         q->setSelectionBehavior( QAbstractItemView::SelectRows );
@@ -203,15 +310,30 @@ WindowItemsList::WindowItemsList(character::profession profession, character::ra
 
         q->verticalHeader()->setVisible( false );
 
+        // Start off in item id order; nothing gets sorted (or has its
+        // text looked up for the sort) until a column header is clicked
+        q->horizontalHeader()->setSortIndicator( -1, Qt::AscendingOrder );
+
         q->setSelectionMode( QAbstractItemView::SingleSelection );
         q->setDragEnabled( true );
+        q->setDragDropMode( QAbstractItemView::DragOnly );
+
+        m_model->setFont( QFont("Wizardry", 9 * m_scale, QFont::Thin) );
 
+        m_cols = loadColumnsFromRegistry();
         populateColumns();
     }
 
+    connect( Settings::getSettings(), &Settings::valueChanged, this, &WindowItemsList::settingChanged );
+
+    // Results are refreshed as more of the index gets built, but only
+    // once it's finished for a language, not on every slice of it
+    connect( ItemSearchIndex::getIndex(), &ItemSearchIndex::ready, this, &WindowItemsList::searchIndexReady );
+    ItemSearchIndex::getIndex()->build();
+
     updateFilter();
 
-    this->setMinimumSize( 420 * m_scale, 355 * m_scale );
+    this->setMinimumSize( 420 * m_scale, 500 * m_scale );
 
     show();
 }
@@ -226,9 +348,7 @@ QList<DialogChooseColumns::column> WindowItemsList::loadColumnsFromRegistry()
 {
     QList<DialogChooseColumns::column> cols;
 
-    QSettings settings;
-
-    QVariant v = settings.value("Items List Columns");
+    QVariant v = Settings::getSettings()->value("Items List Columns");
 
     if (v.isNull())
     {
@@ -258,19 +378,8 @@ QList<DialogChooseColumns::column> WindowItemsList::loadColumnsFromRegistry()
 
 void WindowItemsList::populateColumns()
 {
-    if (QTableWidget *q = qobject_cast<QTableWidget *>(m_widgets[ TABLE_ITEMS ]))
-    {
-        QList<DialogChooseColumns::column> cols = loadColumnsFromRegistry();
-
-        QStringList headers;
-        for (int k=0; k < cols.size(); k++)
-        {
-            headers << ::getBaseStringTable()->getString( cols[k] );
-        }
-
-        q->setColumnCount( cols.size() );
-        q->setHorizontalHeaderLabels( headers );
-    }
+    // The headers come from the model too
+    m_model->setColumns( m_cols );
 }
 
 void WindowItemsList::tableMenu(QPoint pos)
@@ -299,7 +408,7 @@ void WindowItemsList::closeEvent(QCloseEvent *event)
 
 void WindowItemsList::chooseColumns()
 {
-    QList<DialogChooseColumns::column> cols = loadColumnsFromRegistry();
+    QList<DialogChooseColumns::column> cols = m_cols;
 
     DialogChooseColumns d( cols, this );
 
@@ -316,10 +425,19 @@ void WindowItemsList::chooseColumns()
         {
             s += "," + QString::number( cols[k] );
         }
-        QSettings settings;
-
         Q_ASSERT( s.length() > 1 );
-        settings.setValue( "Items List Columns", s.mid(1) );
+
+        // The table gets rebuilt by settingChanged() if this actually
+        // changes anything
+        Settings::getSettings()->setValue( "Items List Columns", s.mid(1) );
+    }
+}
+
+void WindowItemsList::settingChanged(const QString &key, const QVariant &)
+{
+    if (key == "Items List Columns")
+    {
+        m_cols = loadColumnsFromRegistry();
 
         populateColumns();
         updateFilter();
@@ -341,6 +459,8 @@ void WindowItemsList::setScale(double scale)
         }
     }
 
+    m_model->setFont( QFont("Wizardry", 9 * m_scale, QFont::Thin) );
+
     this->resize( sizeHint() );
 
     this->update();
@@ -357,14 +477,14 @@ void WindowItemsList::resizeEvent(QResizeEvent *event)
     // than rescaling the window itself like we do for all other windows in this
     // app. this is because it is more useful here to be able to make more space
     // for new columns to be added, or columns to be made wider instead.
-    if (QTableWidget *q = qobject_cast<QTableWidget *>(m_widgets[ TABLE_ITEMS ]))
+    if (QTableView *q = qobject_cast<QTableView *>(m_widgets[ TABLE_ITEMS ]))
     {
-        // The table initially starts off at position 10 * m_scale, 145 * m_scale
+        // The table initially starts off at position 10 * m_scale, 290 * m_scale
         // and has initial dimensions 400 * m_scale x 200 * m_scale.
         // It will continue to stay at the same position but we change its size:
 
         q->resize( new_width - (10 + 10) * m_scale,
-                   new_height - (145 + 10) * m_scale );
+                   new_height - (290 + 10) * m_scale );
     }
 }
 
@@ -378,19 +498,29 @@ QPixmap WindowItemsList::makeDialogForm()
     m_bgImg = SLFFile::getPixmapFromSlf( "DIALOGS/DIALOGBACKGROUND.STI", 0 );
     bgDdl   = SLFFile::getPixmapFromSlf( "CHAR GENERATION/CG_PROFESSION.STI", 0 );
 
-    QPixmap customImage( QSize( 420, 145 ) );
+    QPixmap customImage( QSize( 420, 290 ) );
 
     QPainter p;
 
     p.begin( &customImage );
-    p.drawPixmap(   0,   0, m_bgImg,                      0,                       0, m_bgImg.width(), 145 );
-    p.drawPixmap( 240,   0, m_bgImg,  m_bgImg.width() - 180,                       0,             180, 145 );
-    p.drawPixmap(   0, 125, m_bgImg,                      0,   m_bgImg.height() - 20, m_bgImg.width(),  20 );
-    p.drawPixmap( 240, 125, m_bgImg,  m_bgImg.width() - 180,   m_bgImg.height() - 20,             180,  20 );
+    p.drawPixmap(   0,   0, m_bgImg,                      0,                       0, m_bgImg.width(), 150 );
+    p.drawPixmap( 240,   0, m_bgImg,  m_bgImg.width() - 180,                       0,             180, 150 );
+    // The dialog background isn't tall enough for all the filters, so
+    // repeat the plain middle of it down to the bottom edge
+    for (int y = 150; y < 270; y += 130)
+    {
+        int h = qMin( 130, 270 - y );
+
+        p.drawPixmap(   0,   y, m_bgImg,                      0,                      20, m_bgImg.width(),   h );
+        p.drawPixmap( 240,   y, m_bgImg,  m_bgImg.width() - 180,                      20,             180,   h );
+    }
+    p.drawPixmap(   0, 270, m_bgImg,                      0,   m_bgImg.height() - 20, m_bgImg.width(),  20 );
+    p.drawPixmap( 240, 270, m_bgImg,  m_bgImg.width() - 180,   m_bgImg.height() - 20,             180,  20 );
 
     p.drawPixmap( 164,   4, bgDdl,  15,   4, 200,  46 );
     p.drawPixmap( 164,  45, bgDdl,  15,  55, 200,  46 );
-    p.drawPixmap( 164,  86, bgDdl,  15, 106, 200,  40 );
+    p.drawPixmap( 164,  86, bgDdl,  15,  55, 200,  46 );
+    p.drawPixmap( 164, 127, bgDdl,  15, 106, 200,  40 );
 
     p.end();
 
@@ -559,6 +689,20 @@ void WindowItemsList::populateDDLGenders(WDDL *ddl)
     }
 }
 
+void WindowItemsList::populateDDLTypes(WDDL *ddl)
+{
+    if (ddl)
+    {
+        for (int k = item::type::ShortWeapon; k <= item::type::Other; k++)
+        {
+            QListWidgetItem *type = new QListWidgetItem( ::getBaseStringTable()->getString( StringList::LISTItemTypes + k ));
+            type->setData( Qt::UserRole, k );
+
+            ddl->addItem( type );
+        }
+    }
+}
+
 void WindowItemsList::ddlChanged(int value)
 {
     if (sender() == m_widgets[ DDL_PROFS ])
@@ -567,6 +711,8 @@ void WindowItemsList::ddlChanged(int value)
         m_race_filter = static_cast<character::race> (value);
     else if (sender() == m_widgets[ DDL_GENDERS ])
         m_gender_filter = static_cast<character::gender> (value);
+    else if (sender() == m_widgets[ DDL_TYPES ])
+        m_type_filter = value;
 
     updateFilter();
 }
@@ -594,6 +740,13 @@ void WindowItemsList::ddlActive()
             ddl->showDDL( false );
         }
     }
+    if (sender() != m_widgets[ DDL_TYPES ])
+    {
+        if (WDDL *ddl = qobject_cast<WDDL *>(m_widgets[ DDL_TYPES ] ))
+        {
+            ddl->showDDL( false );
+        }
+    }
 }
 
 void WindowItemsList::filterProf(int state)
@@ -659,539 +812,90 @@ void WindowItemsList::filterSex(int state)
     }
 }
 
-void WindowItemsList::updateFilter()
+void WindowItemsList::filterType(int state)
 {
-    QList<quint16> items = dbHelper::getHelper()->getFilteredItems( m_prof_filter, m_race_filter, m_gender_filter );
-
-    if (QTableWidget *q = qobject_cast<QTableWidget *>(m_widgets[ TABLE_ITEMS ]))
+    if (WDDL *ddl = qobject_cast<WDDL *>(m_widgets[ DDL_TYPES ] ))
     {
-        q->clearContents();
-        q->setRowCount( items.size() );
-
-        q->setSortingEnabled( false );
-
-        QFont wizFont("Wizardry", 9 * m_scale, QFont::Thin);
-
-        for (int i=0; i < items.size(); i++)
+        ddl->setEnabled( state == Qt::Checked );
+        if (state == Qt::Checked)
         {
-            item    rowitem(items[i]);
-
-            QList<DialogChooseColumns::column> cols = loadColumnsFromRegistry();
-
-            for (int k=0; k < cols.size(); k++)
-            {
-                bool    numeric = false;
-                QString prop = lookupItemProperty( &rowitem, cols[k], &numeric );
-                WTableWidgetItem *cell = new WTableWidgetItem( prop );
-
-                Qt::ItemFlags flags = cell->flags();
-
-                flags &= ~Qt::ItemIsEditable; // all cells are read only
-
-                if (cols[k] == DialogChooseColumns::Name)
-                {
-                    flags |= Qt::ItemIsDragEnabled;
-                    cell->setData( Qt::UserRole, items[i] );
-                }
-                else
-                    flags &= ~Qt::ItemIsDragEnabled;
-
-                cell->setFlags( flags );
-
-                cell->setFont(wizFont);
-                cell->setTextAlignment( (numeric ? Qt::AlignRight : Qt::AlignLeft ) | Qt::AlignVCenter);
-
-                q->setItem( i, k, cell );
-            }
+            // pick up whatever type the list is showing
+            m_type_filter = ddl->getValue();
+        }
+        else
+        {
+            m_type_filter = -1;
         }
-        q->setSortingEnabled( true );
+        updateFilter();
     }
 }
 
-QString WindowItemsList::lookupItemProperty( item *i, DialogChooseColumns::column col, bool *numeric)
+void WindowItemsList::filterChanged(int)
 {
-    QString prop = "";
-
-    if (numeric)
-        *numeric = false;
-
-    switch (col)
-    {
-        case DialogChooseColumns::Name:
-        {
-            prop = i->getName();
-            break;
-        }
-
-        case DialogChooseColumns::Type:
-        {
-            prop = ::getBaseStringTable()->getString( StringList::LISTItemTypes + i->getType() );
-            break;
-        }
-
-        case DialogChooseColumns::Equippable:
-        {
-            switch (i->getType())
-            {
-                case item::type::ShortWeapon:
-                case item::type::ExtendedWeapon:
-                case item::type::ThrownWeapon:
-                case item::type::RangedWeapon:
-                    prop = ::getBaseStringTable()->getString( StringList::PrimaryWeapon );
-                    if (i->canSecondary())
-                    {
-                        prop += ", " + ::getBaseStringTable()->getString( StringList::SecondaryWeapon );
-                    }
-                    break;
-
-                case item::type::Ammunition: // should have secondary set - but don't
-                case item::type::Shield: // should have secondary set - but don't
-                    prop = ::getBaseStringTable()->getString( StringList::SecondaryWeapon );
-                    break;
-
-                case item::type::TorsoArmor:
-                    prop = ::getBaseStringTable()->getString( StringList::Torso );
-                    break;
-
-                case item::type::LegArmor:
-                    prop = ::getBaseStringTable()->getString( StringList::Legs );
-                    break;
-
-                case item::type::HeadGear:
-                    prop = ::getBaseStringTable()->getString( StringList::Head );
-                    break;
-
-                case item::type::Gloves:
-                    prop = ::getBaseStringTable()->getString( StringList::Hands );
-                    break;
-
-                case item::type::Shoes:
-                    prop = ::getBaseStringTable()->getString( StringList::Feet );
-                    break;
-
-                case item::type::MiscEquipment:
-                    prop = ::getBaseStringTable()->getString( StringList::MiscItem1 ) + ", " + ::getBaseStringTable()->getString( StringList::MiscItem2 );
-                    break;
-
-                case item::type::Cloak:
-                    prop = ::getBaseStringTable()->getString( StringList::Cloak );
-                    break;
-
-                default:
-                    break;
-            }
-            break;
-        }
-
-        case DialogChooseColumns::AC:
-        {
-            if (numeric)
-                *numeric = true;
-
-            if (i->getAC() > 0)
-                prop = QString( "+%1" ).arg( i->getAC() );
-            else if (i->getAC() < 0)
-                prop = QString( "%1" ).arg( i->getAC() );
-            break;
-        }
-
-        case DialogChooseColumns::Weight:
-        {
-            if (numeric)
-                *numeric = true;
-
-            prop = QString( tr("%1 pounds") ).arg( i->getWeight(), 0, 'f', 1 );
-            break;
-        }
-
-        case DialogChooseColumns::WeightClass:
-        {
-            prop = i->getArmorWeightClassString();
-            break;
-        }
-
-        case DialogChooseColumns::Damage:
-        {
-            quint16 min_damage, max_damage;
-            int     percentage;
-
-            if (numeric)
-                *numeric = true;
-
-            i->getDamage( &min_damage, &max_damage, &percentage );
-            if (percentage != 0)
-                prop = QString( "+%1%" ).arg(percentage);
-            else if (max_damage != 0)
-                prop = QString( "%1 - %2" ).arg(min_damage).arg(max_damage);
-            break;
-        }
-
-        case DialogChooseColumns::ToHit:
-        {
-            if (numeric)
-                *numeric = true;
-
-            if (i->getToHit() > 0)
-                prop = QString( "+%1" ).arg( i->getToHit() );
-            else if (i->getToHit() < 0)
-                prop = QString( "%1" ).arg( i->getToHit() );
-            break;
-        }
-
-        case DialogChooseColumns::Initiative:
-        {
-            if (numeric)
-                *numeric = true;
-
-            if (i->getInitiative() > 0)
-                prop = QString( "+%1" ).arg( i->getInitiative() );
-            else if (i->getInitiative() < 0)
-                prop = QString( "%1" ).arg( i->getInitiative() );
-            break;
-        }
-
-        case DialogChooseColumns::Hands:
-        {
-            if (i->canSecondary())
-                prop = "Primary or Secondary";
-            else if (i->needs2Hands())
-                prop = "2 Handed Weapon";
-            else if ((i->getType() == item::type::ShortWeapon) ||
-                     (i->getType() == item::type::ExtendedWeapon) ||
-                     (i->getType() == item::type::ThrownWeapon) ||
-                     (i->getType() == item::type::RangedWeapon))
-            {
-                prop = "Primary";
-            }
-            break;
-        }
-
-        case DialogChooseColumns::Cursed:
-        {
-            switch (i->getType())
-            {
-                case item::type::ShortWeapon:
-                case item::type::ExtendedWeapon:
-                case item::type::ThrownWeapon:
-                case item::type::RangedWeapon:
-                case item::type::Shield:
-                case item::type::TorsoArmor:
-                case item::type::LegArmor:
-                case item::type::HeadGear:
-                case item::type::Gloves:
-                case item::type::Shoes:
-                case item::type::MiscEquipment:
-                case item::type::Cloak:
-                    if (! i->isCursed() )
-                        prop = "No";
-                    else
-                        prop = "Yes";
-                    break;
-
-                default:
-                    break;
-            }
-            break;
-        }
-
-        case DialogChooseColumns::SpecialAttack:
-        {
-            prop = i->getSpecialAttackString();
-            break;
-        }
-
-        case DialogChooseColumns::DoubleDamage:
-        {
-            prop = i->getSlaysString();
-            break;
-        }
-
-        case DialogChooseColumns::Price:
-        {
-            if (numeric)
-                *numeric = true;
-
-             prop = QString( "%1" ).arg( i->getPrice() );
-             break;
-        }
-
-        case DialogChooseColumns::Stackable:
-        {
-             prop = i->isStackable() ? "Yes" : "No";
-             break;
-        }
-
-        case DialogChooseColumns::SkillsUsed:
-        {
-             prop = i->getSkillUsedString();
-             break;
-        }
-
-        case DialogChooseColumns::BonusSwings:
-        {
-            if (numeric)
-                *numeric = true;
-
-            if (i->getBonusSwings() > 0)
-                prop = QString( "+%1" ).arg( i->getBonusSwings() );
-            else if (i->getBonusSwings() < 0)
-                prop = QString( "%1" ).arg( i->getBonusSwings() );
-            break;
-        }
-
-        case DialogChooseColumns::Spell:
-        {
-            int power;
-            spell spl = i->getSpell(&power);
-            QString spell_name = spl.getName();
-            if (spell_name.size() > 0)
-            {
-                if (i->getType() == item::type::Spellbook)
-                {
-                    // Don't show a power level because spellbooks don't actually "cast" the spell
-                    prop = QString( "%1 (Lvl %2)" ).arg( spell_name ).arg( spl.getLevel() );
-                }
-                else
-                {
-                    prop = QString( "%1 (Pwr %2)" ).arg( spell_name ).arg( power );
-                }
-            }
-            break;
-        }
-
-        case DialogChooseColumns::HPRegen:
-        {
-            if (numeric)
-                *numeric = true;
-
-            if (i->getHPRegen() > 0)
-                prop = QString( "+%1" ).arg( i->getHPRegen() );
-            else if (i->getHPRegen() < 0)
-                prop = QString( "%1" ).arg( i->getHPRegen() );
-            break;
-        }
-
-        case DialogChooseColumns::StaminaRegen:
-        {
-            if (numeric)
-                *numeric = true;
-
-            if (i->getStaminaRegen() > 0)
-                prop = QString( "+%1" ).arg( i->getStaminaRegen() );
-            else if (i->getStaminaRegen() < 0)
-                prop = QString( "%1" ).arg( i->getStaminaRegen() );
-            break;
-        }
-
-        case DialogChooseColumns::SPRegen:
-        {
-            if (numeric)
-                *numeric = true;
-
-            if (i->getSPRegen() > 0)
-                prop = QString( "+%1" ).arg( i->getSPRegen() );
-            else if (i->getSPRegen() < 0)
-                prop = QString( "%1" ).arg( i->getSPRegen() );
-            break;
-        }
-
-        case DialogChooseColumns::AttribBonus:
-        {
-            int bonus;
-            character::attribute a = i->getAttributeBonus( &bonus );
-
-            if ((a != character::attribute::ATTRIBUTE_NONE) && (bonus != 0))
-            {
-                QString attribStr = ::getBaseStringTable()->getString( StringList::LISTPrimaryAttributes + static_cast<int>(a) );
-
-                if (bonus > 0)
-                {
-                    prop = QString( "%1 +%2" ).arg( attribStr ).arg( bonus );
-                }
-                else
-                {
-                    prop = QString( "%1 %2" ).arg( attribStr ).arg( bonus );
-                }
-            }
-            break;
-        }
-
-        case DialogChooseColumns::SkillBonus:
-        {
-            int bonus;
-            character::skill sk = i->getSkillBonus( &bonus );
-
-            if ((sk != character::skill::SKILL_NONE) && (bonus != 0))
-            {
-                QString skillStr = ::getBaseStringTable()->getString( StringList::LISTSkills + static_cast<int>(sk) );
-
-                if (bonus > 0)
-                {
-                    prop = QString( "%1 +%2" ).arg( skillStr ).arg( bonus );
-                }
-                else
-                {
-                    prop = QString( "%1 %2" ).arg( skillStr ).arg( bonus );
-                }
-            }
-            break;
-        }
-
-        case DialogChooseColumns::MagicResistances:
-        {
-            int f=0, w=0, a=0, e=0, m=0, d=0;
-
-            if (i->getResistance(&f, &w, &a, &e, &m, &d))
-            {
-                QString list;
-
-                // Possibly a problem for some languages. Expectation is the first 2 chars of all of these are ", "
-                // so they can be jumped over for the first item in the list by the mid() call below
-                if (f) list += QString( tr(", %1% vs Fire") ).arg(f);
-                if (w) list += QString( tr(", %1% vs Water") ).arg(w);
-                if (a) list += QString( tr(", %1% vs Air") ).arg(a);
-                if (e) list += QString( tr(", %1% vs Earth") ).arg(e);
-                if (m) list += QString( tr(", %1% vs Mental") ).arg(m);
-                if (d) list += QString( tr(", %1% vs Divine") ).arg(d);
-
-                prop = list.mid(2);
-            }
-            break;
-        }
-
-        case DialogChooseColumns::Required:
-        {
-            QString required = i->getRequiredAttribsString();
-            QString required_s = i->getRequiredSkillsString();
-            if (required.size() == 0)
-            {
-                required   = required_s;
-                required_s = "";
-            }
-            /* NOT else if */
-            if (required.size() > 0)
-            {
-                if (required_s.size() > 0)
-                    required += ", " + required_s;
-
-                prop = required;
-            }
-            break;
-        }
-
-        case DialogChooseColumns::AttackModes:
-        {
-            prop = i->getAttacksString();
-            break;
-        }
+    updateFilter();
+}
 
-        case DialogChooseColumns::Special:
-        {
-            prop = i->getSpecialAttackString();
-            if (i->getBonusSwings() != 0)
-                prop += QString("; %1 bonus swings").arg( i->getBonusSwings() );
-            if (i->getHPRegen() != 0)
-                prop += QString("; %1 HP Regen").arg( i->getHPRegen() );
-            if (i->getStaminaRegen() != 0)
-                prop += QString("; %1 Stamina Regen").arg( i->getStaminaRegen() );
-            if (i->getSPRegen() != 0)
-                prop += QString("; %1 SP Regen").arg( i->getSPRegen() );
-
-            int bonus;
-            character::attribute a = i->getAttributeBonus( &bonus );
-
-            if ((a != character::attribute::ATTRIBUTE_NONE) && (bonus != 0))
-            {
-                QString attribStr = ::getBaseStringTable()->getString( StringList::LISTPrimaryAttributes + static_cast<int>(a) );
+void WindowItemsList::searchChanged(const QString &text)
+{
+    m_search = text.trimmed();
 
-                if (bonus > 0)
-                {
-                    prop += QString( "; %1 +%2" ).arg( attribStr ).arg( bonus );
-                }
-                else
-                {
-                    prop += QString( "; %1 %2" ).arg( attribStr ).arg( bonus );
-                }
-            }
+    updateFilter();
+}
 
-            character::skill sk = i->getSkillBonus( &bonus );
+void WindowItemsList::searchIndexReady()
+{
+    if (! m_search.isEmpty())
+    {
+        updateFilter();
+    }
+}
 
-            if ((sk != character::skill::SKILL_NONE) && (bonus != 0))
-            {
-                QString skillStr = ::getBaseStringTable()->getString( StringList::LISTSkills + static_cast<int>(sk) );
+void WindowItemsList::updateFilter()
+{
+    ItemFilter     allowed = ItemFilter::usableBy( character::professions( m_prof_filter ) ) &
+                             ItemFilter::usableBy( character::races( m_race_filter ) ) &
+                             ItemFilter::usableBy( character::genders( m_gender_filter ) );
+    QList<quint16> ranked;
+
+    if (m_type_filter != -1)
+        allowed &= ItemFilter::ofType( static_cast<item::type>( m_type_filter ) );
+
+    if (isChecked( m_widgets[ CB_TWO_HANDED ] ))
+        allowed &= ItemFilter::withFlag( ItemFilter::TwoHanded );
+    if (isChecked( m_widgets[ CB_CURSED ] ))
+        allowed &= ItemFilter::withFlag( ItemFilter::Cursed );
+    if (isChecked( m_widgets[ CB_SPECIAL ] ))
+        allowed &= ItemFilter::withSpecialAttack( item::special_attacks( QFlag( 0xffff ) ) );
+
+    // Weights are whole pounds in the controls and tenths in the database
+    applyRange( allowed, ItemFilter::Weight, m_widgets[ VAL_WEIGHT_MIN ], m_widgets[ VAL_WEIGHT_MAX ], 10 );
+    applyRange( allowed, ItemFilter::Price,  m_widgets[ VAL_PRICE_MIN ],  m_widgets[ VAL_PRICE_MAX ],   1 );
+    applyRange( allowed, ItemFilter::AC,     m_widgets[ VAL_AC_MIN ],     m_widgets[ VAL_AC_MAX ],      1 );
+
+    if (! m_search.isEmpty())
+    {
+        // The proxy keeps the search ranking, of those items the other
+        // filters allow
+        ranked = ItemSearchIndex::getIndex()->search( m_search );
+    }
 
-                if (bonus > 0)
-                {
-                    prop += QString( "; %1 +%2" ).arg( skillStr ).arg( bonus );
-                }
-                else
-                {
-                    prop += QString( "; %1 %2" ).arg( skillStr ).arg( bonus );
-                }
-            }
-            if (prop.startsWith("; "))
-                prop = prop.mid(2);
-            break;
-        }
+    // Any cells already worked out are only thrown away if the names
+    // could have changed
+    m_model->refreshIfLanguageChanged();
 
-        case DialogChooseColumns::Profs:
-        {
-            character::professions profs =  i->getUsableProfessions();
-
-            prop  = (profs & character::profession::Fighter  ) ? "F" : "-";
-            prop += (profs & character::profession::Lord     ) ? "L" : "-";
-            prop += (profs & character::profession::Valkyrie ) ? "V" : "-";
-            prop += (profs & character::profession::Ranger   ) ? "R" : "-";
-            prop += (profs & character::profession::Samurai  ) ? "S" : "-";
-            prop += (profs & character::profession::Ninja    ) ? "N" : "-";
-            prop += (profs & character::profession::Monk     ) ? "m" : "-";
-            prop += (profs & character::profession::Rogue    ) ? "r" : "-";
-            prop += (profs & character::profession::Gadgeteer) ? "G" : "-";
-            prop += (profs & character::profession::Bard     ) ? "b" : "-";
-            prop += (profs & character::profession::Priest   ) ? "p" : "-";
-            prop += (profs & character::profession::Alchemist) ? "A" : "-";
-            prop += (profs & character::profession::Bishop   ) ? "B" : "-";
-            prop += (profs & character::profession::Psionic  ) ? "P" : "-";
-            prop += (profs & character::profession::Mage     ) ? "M" : "-";
-
-            break;
-        }
+    if (QTableView *q = qobject_cast<QTableView *>(m_widgets[ TABLE_ITEMS ]))
+    {
+        m_proxy->setFilter( allowed.bits(), ! m_search.isEmpty(), ranked );
 
-        case DialogChooseColumns::Races:
+        // Sorting on a column would lose the order of best match first
+        if (m_search.isEmpty())
         {
-            character::races races =  i->getUsableRaces();
-
-            prop  = (races & character::race::Human    ) ? "H" : "-";
-            prop += (races & character::race::Elf      ) ? "E" : "-";
-            prop += (races & character::race::Dwarf    ) ? "D" : "-";
-            prop += (races & character::race::Gnome    ) ? "G" : "-";
-            prop += (races & character::race::Hobbit   ) ? "h" : "-";
-            prop += (races & character::race::Faerie   ) ? "F" : "-";
-            prop += (races & character::race::Lizardman) ? "L" : "-";
-            prop += (races & character::race::Dracon   ) ? "d" : "-";
-            prop += (races & character::race::Felpurr  ) ? "f" : "-";
-            prop += (races & character::race::Rawulf   ) ? "R" : "-";
-            prop += (races & character::race::Mook     ) ? "M" : "-";
-            prop += (races & character::race::Trynnie  ) ? "t" : "-";
-            prop += (races & character::race::TRang    ) ? "T" : "-";
-            prop += (races & character::race::Umpani   ) ? "U" : "-";
-            prop += (races & character::race::Rapax    ) ? "r" : "-";
-            prop += (races & character::race::Android  ) ? "A" : "-";
-
-            break;
+            q->setSortingEnabled( true );
         }
-
-        case DialogChooseColumns::Genders:
+        else
         {
-            if (i->getUsableGenders() == character::gender::Male)
-                prop = "M-";
-            else if (i->getUsableGenders() == character::gender::Female)
-                prop = "-F";
-            else
-                prop = "MF";
-            break;
+            q->setSortingEnabled( false );
+            m_proxy->sort( 0 );
         }
     }
-
-    return prop;
 }
@@ -43,6 +43,9 @@ class QMenu;
 
 class WDDL;
 
+class ItemsTableModel;
+class ItemsFilterProxyModel;
+
 class WindowItemsList : public QWidget, public Wizardry8Scalable
 {
     Q_OBJECT
@@ -63,6 +66,8 @@ public slots:
     void        filterProf(int);
     void        filterRace(int);
     void        filterSex(int);
+    void        filterType(int);
+    void        filterChanged(int);
 
     void        ddlChanged(int value);
     void        ddlActive();
@@ -70,13 +75,16 @@ public slots:
     void        tableMenu(QPoint pos);
     void        chooseColumns();
 
+    void        settingChanged(const QString &key, const QVariant &value);
+
+    void        searchChanged(const QString &text);
+    void        searchIndexReady();
+
 protected:
     void        closeEvent(QCloseEvent *event) override;
     void        resizeEvent(QResizeEvent *event) override;
 
 private:
-    QString     lookupItemProperty( item *i, DialogChooseColumns::column col, bool *numeric );
-
     QList<DialogChooseColumns::column> loadColumnsFromRegistry();
 
     void        populateColumns();
@@ -86,12 +94,21 @@ private:
     void        populateDDLProfessions(WDDL *ddl);
     void        populateDDLRaces(WDDL *ddl);
     void        populateDDLGenders(WDDL *ddl);
+    void        populateDDLTypes(WDDL *ddl);
 
     QPixmap     makeDialogForm();
 
     character::profession  m_prof_filter;
     character::race        m_race_filter;
     character::gender      m_gender_filter;
+    int                    m_type_filter;      // item::type, or -1 for any
+
+    QList<DialogChooseColumns::column> m_cols;
+
+    QString     m_search;
+
+    ItemsTableModel        *m_model;
+    ItemsFilterProxyModel  *m_proxy;
 
     QPixmap     m_bgImg;
     QMap<int, QWidget *>   m_widgets;
@@ -80,6 +80,7 @@ QT       += xml
 
 QT       += gui
 QT       += widgets
+QT       += concurrent
 QT       += multimedia
 
 TARGET = Wizardry8Editor
@@ -103,6 +104,7 @@ SOURCES += main.cpp \
            WSpinBox.cpp \
            WStatBar.cpp \
            Localisation.cpp \
+           Settings.cpp \
            MainWindow.cpp \
            RIFFFile.cpp \
            SLFFile.cpp \
@@ -140,8 +142,6 @@ SOURCES += main.cpp \
            Touch.cpp \
            Window3DNavigator.cpp \
            WindowDroppedItems.cpp \
-           WTableWidgetItem.h \
-           WTableWidget.h \
            WindowItemsList.cpp \
            WindowFactEditor.cpp \
            Avatar.cpp \
@@ -150,6 +150,12 @@ SOURCES += main.cpp \
            facts.cpp \
            party.cpp \
            item.cpp \
+           ItemIconAtlas.cpp \
+           ItemFilter.cpp \
+           ItemSearchIndex.cpp \
+           ItemsTableModel.cpp \
+           FactsTableModel.cpp \
+           ItemExport.cpp \
            spell.cpp \
            bspatch.c
 
@@ -167,6 +173,7 @@ HEADERS += Wizardry8Style.h \
            WSpinBox.h \
            WStatBar.h \
            Localisation.h \
+           Settings.h \
            MainWindow.h \
            RIFFFile.h \
            SLFFile.h \
@@ -214,6 +221,12 @@ HEADERS += Wizardry8Style.h \
            facts.h \
            party.h \
            item.h \
+           ItemIconAtlas.h \
+           ItemFilter.h \
+           ItemSearchIndex.h \
+           ItemsTableModel.h \
+           FactsTableModel.h \
+           ItemExport.h \
            spell.h \
            constants.h \
            common.h \
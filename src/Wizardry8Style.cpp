@@ -131,6 +131,19 @@ Wizardry8Style::Wizardry8Style() :
         m_spinner = new STI( array );
         spinner.close();
     }
+
+    // Convert every state of every skin element into a pixmap once, in
+    // the orientation it gets drawn in, rather than on every repaint
+    prepareSkin( SKIN_ARROW_UP,    m_up_arrow,   0,               4,   0 );
+    prepareSkin( SKIN_ARROW_DOWN,  m_down_arrow, 0,               4,   0 );
+    prepareSkin( SKIN_ARROW_LEFT,  m_up_arrow,   0,               4, 270 );
+    prepareSkin( SKIN_ARROW_RIGHT, m_down_arrow, 0,               4, 270 );
+    prepareSkin( SKIN_SBSLIDER_V,  m_sbslider,   0,               4,   0 );
+    prepareSkin( SKIN_SBSLIDER_H,  m_sbslider,   0,               4,  90 );
+    prepareSkin( SKIN_SLIDER,      m_slider,     0,               4,   0 );
+    prepareSkin( SKIN_CHECKBOX,    m_cb,         CB_OFFSET,       4,   0 );
+    prepareSkin( SKIN_SPIN_SUB,    m_spinner,    SPIN_SUB_OFFSET, 5,   0 );
+    prepareSkin( SKIN_SPIN_ADD,    m_spinner,    SPIN_ADD_OFFSET, 5,   0 );
 }
 
 Wizardry8Style::~Wizardry8Style()
@@ -679,6 +692,69 @@ QRect Wizardry8Style::subControlRect(ComplexControl control,
     return rect;
 }
 
+void Wizardry8Style::prepareSkin(skin element, STI *sti, int first, int num, int rotation)
+{
+    m_skin[element].clear();
+
+    if (sti == NULL)
+        return;
+
+    QTransform rot;
+    rot.rotate(rotation);
+
+    for (int k = 0; k < num; k++)
+    {
+        QImage img = sti->getImage( first + k );
+
+        if ((rotation != 0) && !img.isNull())
+            img = img.transformed( rot );
+
+        m_skin[element] << QPixmap::fromImage( img );
+    }
+}
+
+void Wizardry8Style::drawSkin(QPainter *painter, const QRect &rect, skin element, int state) const
+{
+    if ((state < 0) || (state >= m_skin[element].size()) || rect.isEmpty())
+        return;
+
+    const QPixmap &src = m_skin[element].at( state );
+    if (src.isNull())
+        return;
+
+    // The scaled copy is made at device resolution so that the final
+    // drawPixmap() is a straight blit. The window scale only changes when
+    // the user asks for it, so very few distinct sizes ever get used.
+    qreal  dpr  = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    QSize  size = rect.size() * dpr;
+
+    if (size == src.size())
+    {
+        painter->drawPixmap( rect, src );
+        return;
+    }
+
+    quint64 key = ((quint64)element          << 56) |
+                  ((quint64)state            << 48) |
+                  ((quint64)(size.width()  & 0xffffff) << 24) |
+                   (quint64)(size.height() & 0xffffff);
+
+    QHash<quint64, QPixmap>::const_iterator it = m_scaledSkin.constFind( key );
+    if (it == m_scaledSkin.constEnd())
+    {
+        // Something is resizing continuously (eg. a splitter); don't let
+        // the cache grow without limit
+        if (m_scaledSkin.size() > 512)
+            m_scaledSkin.clear();
+
+        QPixmap scaled = src.scaled( size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation );
+        scaled.setDevicePixelRatio( dpr );
+
+        it = m_scaledSkin.insert( key, scaled );
+    }
+    painter->drawPixmap( rect, it.value() );
+}
+
 void Wizardry8Style::drawPrimitive(PrimitiveElement element,
                                    const QStyleOption *option,
                                    QPainter *painter,
@@ -773,7 +849,6 @@ void Wizardry8Style::drawPrimitive(PrimitiveElement element,
         case PE_IndicatorSpinMinus:
         case PE_IndicatorSpinPlus:
         {
-            QPixmap  pix;
             int state = 0; // normal
 
             if      (!(option->state & State_Enabled))   state = 3;
@@ -785,18 +860,15 @@ void Wizardry8Style::drawPrimitive(PrimitiveElement element,
             else if   (option->state & State_Sunken)     state = 2; // clicked
 
             if (element == PE_IndicatorSpinMinus)
-                pix = QPixmap::fromImage( m_spinner->getImage( SPIN_SUB_OFFSET + state ) );
+                drawSkin(painter, option->rect, SKIN_SPIN_SUB, state);
             else
-                pix = QPixmap::fromImage( m_spinner->getImage( SPIN_ADD_OFFSET + state ) );
-
-            painter->drawPixmap(option->rect, pix);
+                drawSkin(painter, option->rect, SKIN_SPIN_ADD, state);
             break;
         }
 
         // QCheckbox
         case PE_IndicatorCheckBox:
         {
-            QPixmap  pix;
             int state = 0; // normal
 
             if        (!(option->state & State_Enabled)) state = 0; // don't have a disabled icon
@@ -809,8 +881,7 @@ void Wizardry8Style::drawPrimitive(PrimitiveElement element,
             else if     (option->state & State_NoChange) state = 0; // partially checked (& see below)
             else if   (!(option->state & State_Off))     state = 2; // clicked
 
-            pix = QPixmap::fromImage( m_cb->getImage( CB_OFFSET + state ) );
-            painter->drawPixmap(option->rect, pix);
+            drawSkin(painter, option->rect, SKIN_CHECKBOX, state);
 
             // We don't have a partially checked checkbox in the game assets,
             // so make one by drawing a small rect in the centre of the
@@ -831,39 +902,18 @@ void Wizardry8Style::drawPrimitive(PrimitiveElement element,
         case PE_IndicatorArrowLeft:
         case PE_IndicatorArrowRight:
         {
-            QPixmap  pix;
             int state = 0; // normal
 
             if      (!(option->state & State_Enabled))   state = 3; // disabled
             else if   (option->state & State_MouseOver)  state = 1; // mouseover
             else if   (option->state & State_Sunken)     state = 2; // depressed
 
-            if (element == PE_IndicatorArrowUp)
-            {
-                pix = QPixmap::fromImage( m_up_arrow->getImage( state ) );
-            }
-            else if (element == PE_IndicatorArrowDown)
-            {
-                pix = QPixmap::fromImage( m_down_arrow->getImage( state ) );
-            }
-            // Sub-optimal code: Wizardry 8 UI doesn't use horizontal
-            // scrollbars, and this only done for completeness
-            else if (element == PE_IndicatorArrowLeft)
-            {
-                QMatrix rot;
-                rot.rotate(270);
-                QImage left_arrow = m_up_arrow->getImage( state ).transformed( QTransform(rot) );
-                pix = QPixmap::fromImage( left_arrow );
-            }
-            else if (element == PE_IndicatorArrowRight)
-            {
-                QMatrix rot;
-                rot.rotate(270);
-                QImage right_arrow = m_down_arrow->getImage( state ).transformed( QTransform(rot) );
-                pix = QPixmap::fromImage( right_arrow );
-            }
-
-            painter->drawPixmap(option->rect, pix);
+            // Wizardry 8 UI doesn't use horizontal scrollbars; the left and
+            // right arrows are the up and down ones rotated for completeness
+            if      (element == PE_IndicatorArrowUp)     drawSkin(painter, option->rect, SKIN_ARROW_UP,    state);
+            else if (element == PE_IndicatorArrowDown)   drawSkin(painter, option->rect, SKIN_ARROW_DOWN,  state);
+            else if (element == PE_IndicatorArrowLeft)   drawSkin(painter, option->rect, SKIN_ARROW_LEFT,  state);
+            else if (element == PE_IndicatorArrowRight)  drawSkin(painter, option->rect, SKIN_ARROW_RIGHT, state);
             break;
         }
 
@@ -992,29 +1042,19 @@ void Wizardry8Style::drawControl(ControlElement element,
         case CE_ScrollBarSlider:
         {
             // No primitives defined for this one.
-            QPixmap pix;
             int state = 0; // normal
 
             if      (!(option->state & State_Enabled))   state = 3; // disabled
             else if   (option->state & State_MouseOver)  state = 1; // mouseover
             else if   (option->state & State_Sunken)     state = 2; // depressed
 
+            // Sub-optimal code: Wizardry 8 UI doesn't use horizontal
+            // scrollbars, and the horizontal slider is only done for
+            // completeness. The shadowing on the control is wrong for it.
             if (option->state & State_Horizontal)
-            {
-                // Sub-optimal code: Wizardry 8 UI doesn't use horizontal
-                // scrollbars, and this only done for completeness.
-                // The shadowing on the control is wrong when we do this.
-                QMatrix rot;
-                rot.rotate(90);
-                QImage hslider = m_sbslider->getImage( state ).transformed( QTransform(rot) );
-                pix = QPixmap::fromImage( hslider );
-            }
+                drawSkin(painter, option->rect, SKIN_SBSLIDER_H, state);
             else
-            {
-                pix = QPixmap::fromImage( m_sbslider->getImage( state ) );
-            }
-
-            painter->drawPixmap(option->rect, pix);
+                drawSkin(painter, option->rect, SKIN_SBSLIDER_V, state);
             break;
         }
 
@@ -1024,15 +1064,13 @@ void Wizardry8Style::drawControl(ControlElement element,
         case CE_Slider:
         {
             // No primitives defined for this one.
-            QPixmap pix;
             int state = 1; // normal
 
             if      (!(option->state & State_Enabled))   state = 3; // disabled
             else if   (option->state & State_MouseOver)  state = 2; // mouseover
             else if   (option->state & State_Sunken)     state = 2; // depressed
 
-            pix = QPixmap::fromImage( m_slider->getImage( state ) );
-            painter->drawPixmap(option->rect, pix);
+            drawSkin(painter, option->rect, SKIN_SLIDER, state);
             break;
         }
 #pragma GCC diagnostic pop
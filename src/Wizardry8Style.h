@@ -28,6 +28,9 @@
 
 #include <QProxyStyle>
 #include <QPalette>
+#include <QPixmap>
+#include <QHash>
+#include <QVector>
 
 class STI;
 class QSpinBox;
@@ -68,8 +71,32 @@ public:
 
 
 private:
+    // Every skin element drawn by the style, each with its own set of
+    // state frames, already rotated into the orientation it is drawn in
+    enum skin
+    {
+        SKIN_ARROW_UP,
+        SKIN_ARROW_DOWN,
+        SKIN_ARROW_LEFT,
+        SKIN_ARROW_RIGHT,
+        SKIN_SBSLIDER_V,
+        SKIN_SBSLIDER_H,
+        SKIN_SLIDER,
+        SKIN_CHECKBOX,
+        SKIN_SPIN_SUB,
+        SKIN_SPIN_ADD,
+
+        SKIN_SIZE
+    };
+
+    void prepareSkin(skin element, STI *sti, int first, int num, int rotation);
+    void drawSkin(QPainter *painter, const QRect &rect, skin element, int state) const;
+
     mutable QPalette     m_standardPalette;
 
+    QVector<QPixmap>                  m_skin[SKIN_SIZE];
+    mutable QHash<quint64, QPixmap>   m_scaledSkin;
+
     STI *m_up_arrow;
     STI *m_down_arrow;
     STI *m_sbslider;
@@ -3483,6 +3483,72 @@ bool character::isSpellKnown( int idx ) const
     return false;
 }
 
+// Bitset over spell id, for combining with the helper's spell index
+QBitArray character::getKnownSpells() const
+{
+    QBitArray known( MAXIMUM_CHARACTER_SPELLS );
+
+    for (int k = 1; k < MAXIMUM_CHARACTER_SPELLS; k++)
+    {
+        if ((m_spell[k] == 1) || (m_spell[k] == 2))
+            known.setBit( k );
+    }
+    return known;
+}
+
+// Spells not yet known that the character's professions and levels in
+// them allow it to learn. Skill in the realm isn't taken into account.
+QBitArray character::getLearnableSpells() const
+{
+    dbHelper  *helper = dbHelper::getHelper();
+    QBitArray  learnable( helper->getNumSpells() );
+
+    QMapIterator<profession, int> i( m_currentLevels );
+    while (i.hasNext())
+    {
+        i.next();
+
+        QBitArray profSpells = helper->getSpellsForProfessions( i.key() );
+        QBitArray levels( helper->getNumSpells() );
+        bool      pure;
+
+        switch (i.key())
+        {
+            case profession::Priest:
+            case profession::Alchemist:
+            case profession::Bishop:
+            case profession::Psionic:
+            case profession::Mage:
+                pure = true;
+                break;
+
+            default:
+                pure = false;
+                break;
+        }
+
+        for (int level = 1; level <= dbHelper::kMaxSpellLevel; level++)
+        {
+            int needed = pure ? spell::pureClassLevel( level ) : spell::hybridClassLevel( level );
+
+            if (i.value() >= needed)
+                levels |= helper->getSpellsAtLevel( level );
+        }
+
+        learnable |= profSpells & levels;
+    }
+
+    // Spell 0 is the "None" spell
+    if (learnable.size() > 0)
+        learnable.clearBit( 0 );
+
+    // The operators treat the shorter of the two as padded with 0
+    QBitArray known = getKnownSpells();
+    known.resize( learnable.size() );
+
+    return learnable & ~known;
+}
+
 void character::setSpellKnown( int idx, bool known )
 {
     if ((idx > 0) && (idx < MAXIMUM_CHARACTER_SPELLS))
@@ -3497,11 +3563,18 @@ void character::setSpellKnown( int idx, bool known )
             // by a character at the current time - either due to
             // not being supported by the character's class !(spell->getClasses() & m_profession)
             // or current level (spell->getLevelAsPureClass() or spell->getLevelAsHybridClass())
-            // or current skills in the relevant realm and class
-
-            // This app has never actually done this, and just used -1
-            // I'm unaware of this causing any issues and don't intend to fix it unless it does
+            // or current skills in the relevant realm and class, and -1
+            // if it could be learnt.
             m_spell[idx] = -1;
+
+            // getLearnableSpells() leaves out known spells, so ask once
+            // this one is no longer known. It doesn't look at realm skill
+            // either, so a spell held back only by that keeps the -1 this
+            // app has always used.
+            QBitArray learnable = getLearnableSpells();
+
+            if ((idx >= learnable.size()) || ! learnable.testBit( idx ))
+                m_spell[idx] = 0;
         }
     }
     recomputeManaPoints();
@@ -3899,20 +3972,16 @@ void character::recomputeHp()
 
 void character::recomputeKnownSpellsCount()
 {
-    m_knownSpellsCount[ realm::Fire   ] = 0;
-    m_knownSpellsCount[ realm::Water  ] = 0;
-    m_knownSpellsCount[ realm::Air    ] = 0;
-    m_knownSpellsCount[ realm::Earth  ] = 0;
-    m_knownSpellsCount[ realm::Mental ] = 0;
-    m_knownSpellsCount[ realm::Divine ] = 0;
+    dbHelper  *helper = dbHelper::getHelper();
+    QBitArray  known  = getKnownSpells();
 
-    for (int k = 0; k < MAXIMUM_CHARACTER_SPELLS; k++)
+    // Spell 0 isn't counted by getKnownSpells(), but was here
+    if ((m_spell[0] == 1) || (m_spell[0] == 2))
+        known.setBit( 0 );
+
+    for (int r = 0; r < REALM_SIZE; r++)
     {
-        if ((m_spell[k] == 1) || (m_spell[k] == 2))
-        {
-            spell s(k);
-            m_knownSpellsCount[ s.getRealm() ]++;
-        }
+        m_knownSpellsCount[ r ] = (known & helper->getSpellsInRealm( static_cast<realm>(r) )).count( true );
     }
 }
 
@@ -30,6 +30,7 @@
 
 #define MAXIMUM_CHARACTER_SPELLS   456 // Wizardry 1.2.8 supports 4 times as many spells as Wizardry 1.2.4
 
+#include <QBitArray>
 #include <QMetaEnum>
 #include <QMap>
 
@@ -400,6 +401,8 @@ public:
 
     bool          isSpellKnown(int idx) const;
     void          setSpellKnown(int idx, bool known=true);
+    QBitArray     getKnownSpells() const;
+    QBitArray     getLearnableSpells() const;
 
     void          recomputeLoadCategory();
     void          recomputeEverything();
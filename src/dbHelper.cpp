@@ -31,176 +31,400 @@
 
 #define  ITEM_START_OFFSET 0x0004
 #define  ITEM_RECORD_SIZE  0x010d
+#define  SPELL_START_OFFSET 0x0008
 #define  SPELL_RECORD_SIZE 0x02c0
-
-dbHelper *dbHelper::singleton;
-QMutex    dbHelper::alloc_lock;
+#define  MONSTER_START_OFFSET 0x0004
+#define  MONSTER_RECORD_SIZE  0x0297
 
 dbHelper::dbHelper() :
-    m_numItems(0)
+    m_itemdesc_idx_pos(0),
+    m_numItems(0),
+    m_spelldesc_idx_pos(0),
+    m_numSpells(0)
 {
-    m_item_db = new SLFFile("DATABASES/ITEMS.DBS");
+    m_item_db = loadDb("DATABASES/ITEMS.DBS");
 
-    if (m_item_db)
+    if (m_item_db.size() >= ITEM_START_OFFSET)
     {
-        m_item_db->open(QIODevice::ReadOnly);
-
-        m_numItems = m_item_db->readLEUShort();
+        m_numItems = FORMAT_LE16((const quint8 *)m_item_db.constData());
 
-        buildItemQuickFilter();
+        // Don't trust the count beyond what's actually in the file
+        m_numItems = qMin( m_numItems, (int)((m_item_db.size() - ITEM_START_OFFSET) / ITEM_RECORD_SIZE) );
     }
+    buildItemColumns();
 
-    m_itemdesc_db = new SLFFile("DATABASES/ITEMDESC.DBS");
-
-    if (m_itemdesc_db)
-    {
-        m_itemdesc_db->open(QIODevice::ReadOnly);
-
-        m_itemdesc_idx_pos = m_itemdesc_db->size() - 8;
-        m_itemdesc_db->seek( m_itemdesc_idx_pos );
-        m_itemdesc_idx_pos -= 4 * m_itemdesc_db->readLEULong();
-    }
+    m_itemdesc_db      = loadDb("DATABASES/ITEMDESC.DBS");
+    m_itemdesc_idx_pos = descIndexPos( m_itemdesc_db );
 
-    m_spell_db = new SLFFile("DATABASES/SPELLTABLES.DBS");
+    m_spell_db = loadDb("DATABASES/SPELLTABLES.DBS");
 
-    if (m_spell_db)
+    if (m_spell_db.size() >= SPELL_START_OFFSET)
     {
-        m_spell_db->open(QIODevice::ReadOnly);
-
         // number of spells in [0x0000--0x0003]
-        m_spell_idx_pos = 8;
+        m_numSpells = FORMAT_LE32((const quint8 *)m_spell_db.constData());
+        m_numSpells = qMin( m_numSpells, (int)((m_spell_db.size() - SPELL_START_OFFSET) / SPELL_RECORD_SIZE) );
     }
+    buildSpellIndex();
 
-    m_spelldesc_db = new SLFFile("DATABASES/SPELLDESC.DBS");
+    m_spelldesc_db      = loadDb("DATABASES/SPELLDESC.DBS");
+    m_spelldesc_idx_pos = descIndexPos( m_spelldesc_db );
+}
 
-    if (m_spelldesc_db)
-    {
-        m_spelldesc_db->open(QIODevice::ReadOnly);
+dbHelper::~dbHelper()
+{
+}
 
-        m_spelldesc_idx_pos = m_spelldesc_db->size() - 8;
-        m_spelldesc_db->seek( m_spelldesc_idx_pos );
-        m_spelldesc_idx_pos -= 4 * m_spelldesc_db->readLEULong();
+QByteArray dbHelper::loadDb(const QString &filename)
+{
+    QByteArray db;
+    SLFFile    f( filename );
+
+    if (f.open(QIODevice::ReadOnly))
+    {
+        f.readAll( db );
+        f.close();
     }
+    return db;
 }
 
-dbHelper::~dbHelper()
+// The description databases end with an index of offsets to each
+// description, followed by the number of them and 4 more bytes
+qint64 dbHelper::descIndexPos(const QByteArray &db)
 {
-    delete[] m_quick_filter_items;
-    delete m_item_db;
-    delete m_itemdesc_db;
-    delete m_spell_db;
+    if (db.size() < 8)
+        return 0;
+
+    qint64 idx_pos = db.size() - 8;
+
+    return idx_pos - 4 * (qint64)(quint32)FORMAT_LE32((const quint8 *)db.constData() + idx_pos);
 }
 
-void dbHelper::buildItemQuickFilter()
+QString dbHelper::decodeDesc(const QByteArray &db, qint64 idx_pos, quint32 id)
 {
-    m_item_db->seek( ITEM_START_OFFSET );
+    const quint8 *data = (const quint8 *)db.constData();
+    qint64        entry = idx_pos + (qint64)id * sizeof(qint32);
+
+    if ((idx_pos <= 0) || (entry + 4 > db.size() - 8))
+        return "";
+
+    qint64 offset = (quint32)FORMAT_LE32(data + entry);
+
+    // All items and spells seem to have the same byte sequence for the
+    // first 8 bytes: 01 00 00 00 00 ff ff ff
+    // No idea what they mean
+
+    // Next 4 bytes give the character length of the UTF-16LE text description that
+    // follows. Usually it is 0, but sometimes empty descriptions are indicated
+    // by 1 as well
+    if (offset + 12 > db.size())
+        return "";
+
+    qint64 str_len = (quint32)FORMAT_LE32(data + offset + 8);
+
+    if (offset + 12 + str_len * 2 > db.size())
+        return "";
 
-    m_quick_filter_items = new quint64[m_numItems];
+    return Localisation::decode( (const char *)data + offset + 12, str_len*2, true );
+}
+
+void dbHelper::buildItemColumns()
+{
+    itemColumns &c = m_item_columns;
+
+    c.type.resize( m_numItems );
+    c.weight.resize( m_numItems );
+    c.price.resize( m_numItems );
+    c.ac.resize( m_numItems );
+    c.minDamage.resize( m_numItems );
+    c.maxDamage.resize( m_numItems );
+    c.professions.resize( m_numItems );
+    c.races.resize( m_numItems );
+    c.genders.resize( m_numItems );
 
     for (int k=0; k < m_numItems; k++)
     {
-        QByteArray   item_record = m_item_db->read(ITEM_RECORD_SIZE);
-        quint8      *data        = (quint8 *)item_record.constData();
+        const quint8 *data = getItemRecord(k);
+
+        c.type[k]        = data[0x3e];
+        c.ac[k]          = (qint8)data[0x62];
+        c.professions[k] = FORMAT_LE16(data + 0x76);
+        c.races[k]       = FORMAT_LE16(data + 0x78);
+        c.genders[k]     = data[0x7c];
+        c.price[k]       = FORMAT_LE32(data + 0x86);
+        c.weight[k]      = FORMAT_LE16(data + 0x8a);
+
+        // Same rules as item::getDamage() - bows keep a percentage here
+        // instead of any dice, and count as doing no damage themselves
+        quint16 base       = FORMAT_LE16(data + 0x4a);
+        quint8  num_dice   = data[0x4c];
+        quint8  dice_sides = data[0x4d];
+
+        if ((num_dice == 0) && (dice_sides == 0))
+        {
+            c.minDamage[k] = 0;
+            c.maxDamage[k] = 0;
+        }
+        else
+        {
+            c.minDamage[k] = base + num_dice;
+            c.maxDamage[k] = base + num_dice * dice_sides;
+        }
+    }
+}
+
+// Adds item @id to the bitset for @value, making room for it first if
+// it's the biggest value seen yet
+static void addToValueSet(QVector<QBitArray> &sets, int value, int id, int num_items)
+{
+    if (value >= sets.size())
+    {
+        int old_size = sets.size();
 
-        quint64 profs   = FORMAT_LE16(data + 0x76);
-        quint64 races   = FORMAT_LE16(data + 0x78);
-        quint64 genders = FORMAT_8(   data + 0x7c);
+        sets.resize( value + 1 );
+        for (int k=old_size; k < sets.size(); k++)
+            sets[k] = QBitArray( num_items );
+    }
+    sets[ value ].setBit( id );
+}
 
-        m_quick_filter_items[k] = (profs << 32) | (races << 16) | genders;
+static void addToBitSets(QVector<QBitArray> &sets, quint32 bits, int id)
+{
+    for (int b=0; b < sets.size(); b++)
+    {
+        if (bits & (1 << b))
+            sets[ b ].setBit( id );
     }
 }
 
-QList<quint16> dbHelper::getFilteredItems(character::profession prof, character::race race, character::gender gender)
+// Initialisation of the function local static is thread safe, the
+// same as for getHelper()
+const itemBitsets &dbHelper::getItemBitsets() const
+{
+    static const itemBitsets s_bitsets = buildItemBitsets();
+
+    return s_bitsets;
+}
+
+itemBitsets dbHelper::buildItemBitsets() const
 {
-    quint64 p = (quint64) prof;
-    quint64 r = (quint64) race;
-    quint64 g = (quint64) gender;
+    const itemColumns &c = m_item_columns;
+    itemBitsets        s;
 
-    quint64 mask = (p << 32) | (r << 16) | g;
+    s.professions    = QVector<QBitArray>( 16, QBitArray( m_numItems ) );
+    s.races          = QVector<QBitArray>( 16, QBitArray( m_numItems ) );
+    s.genders        = QVector<QBitArray>(  2, QBitArray( m_numItems ) );
+    s.specialAttacks = QVector<QBitArray>( 16, QBitArray( m_numItems ) );
 
-    QList<quint16> items;
+    s.twoHanded = QBitArray( m_numItems );
+    s.secondary = QBitArray( m_numItems );
+    s.cursed    = QBitArray( m_numItems );
+    s.hasSpell  = QBitArray( m_numItems );
 
     for (int k=0; k < m_numItems; k++)
     {
-        if ((m_quick_filter_items[k] & mask) == mask)
+        const quint8 *data = getItemRecord(k);
+
+        // One percentage chance byte per special attack, in bit order
+        quint32 special_attacks = 0;
+        for (int a=0; a < 16; a++)
         {
-            items << (quint16)k;
+            if (data[0x50 + a])
+                special_attacks |= (1 << a);
         }
+
+        addToBitSets( s.professions,    c.professions[k], k );
+        addToBitSets( s.races,          c.races[k],       k );
+        addToBitSets( s.genders,        c.genders[k],     k );
+        addToBitSets( s.specialAttacks, special_attacks,  k );
+
+        addToValueSet( s.type,     c.type[k],  k, m_numItems );
+        addToValueSet( s.stacking, data[0x66], k, m_numItems );
+
+        // Same tests as item::needs2Hands(), canSecondary(), isCursed() and
+        // getSpell()
+        s.twoHanded.setBit( k, (data[0x41] & 4) != 0 );
+        s.secondary.setBit( k, (data[0x41] & 8) != 0 );
+        s.cursed.setBit(    k, data[0x8c] == 1 );
+        s.hasSpell.setBit(  k, data[0x63] != 0 );
     }
+    return s;
+}
 
-    return items;
+QString dbHelper::getItemDesc(quint32 item_id) const
+{
+    return decodeDesc( m_itemdesc_db, m_itemdesc_idx_pos, item_id );
 }
 
-QString dbHelper::getItemDesc(quint32 item_id)
+// Returns a view straight into the in-memory database, which lives as
+// long as the helper does, so no copy or file access is needed. Ids
+// outside the database get an all-zero record rather than NULL.
+const quint8 *dbHelper::getItemRecord(quint32 item_id) const
 {
-    qint32 item_offset;
+    static const quint8 s_empty_record[ITEM_RECORD_SIZE] = { 0 };
 
-    if (m_itemdesc_db->seek( m_itemdesc_idx_pos + item_id * sizeof(qint32) ))
+    if (item_id < (quint32)m_numItems)
     {
-        item_offset = m_itemdesc_db->readLEULong();
-        if (m_itemdesc_db->seek( item_offset ))
-        {
-            // All items seem to have the same byte sequence for the first 8 bytes:
-            // 01 00 00 00 00 ff ff ff
-            // No idea what they mean
-
-            m_itemdesc_db->skip( 8 );
+        return (const quint8 *)m_item_db.constData() + ITEM_START_OFFSET + item_id * ITEM_RECORD_SIZE;
+    }
+    return s_empty_record;
+}
 
-            // Next 4 bytes give the character length of the UTF-16LE text description that
-            // follows. Usually it is 0, but sometimes empty descriptions are indicated
-            // by 1 as well
-            qint32 str_len = m_itemdesc_db->readLEULong();
+QString dbHelper::getSpellDesc(quint32 spell_id) const
+{
+    return decodeDesc( m_spelldesc_db, m_spelldesc_idx_pos, spell_id );
+}
 
-            QByteArray desc = m_itemdesc_db->read( str_len*2 );
+// Same as getItemRecord(), but NULL for ids outside the database, since
+// spells rely on that to know they're null
+const quint8 *dbHelper::getSpellRecord(quint32 spell_id) const
+{
+    if (spell_id < (quint32)m_numSpells)
+    {
+        return (const quint8 *)m_spell_db.constData() + SPELL_START_OFFSET + spell_id * SPELL_RECORD_SIZE;
+    }
+    return NULL;
+}
 
-            return Localisation::decode( desc.constData(), str_len*2, true );
-        }
+// 0x0149: Alchemist
+// 0x015b: Mage
+// 0x0220: Priest
+// 0x0221: Psionic
+// 0x0157--0x015a: Spell level
+// 0x0234--0x0237: Spell realm
+void dbHelper::buildSpellIndex()
+{
+    for (int k=0; k < character::realm::REALM_SIZE; k++)
+        m_spells_by_realm[k].resize( m_numSpells );
+    for (int k=0; k <= kMaxSpellLevel; k++)
+        m_spells_by_level[k].resize( m_numSpells );
+    for (int k=0; k < SCHOOL_SIZE; k++)
+        m_spells_by_school[k].resize( m_numSpells );
+
+    for (int k=0; k < m_numSpells; k++)
+    {
+        const quint8 *data = getSpellRecord(k);
+
+        quint32 realm = FORMAT_LE32(data + 0x234);
+        quint32 level = FORMAT_LE32(data + 0x157);
+
+        if (realm < character::realm::REALM_SIZE)
+            m_spells_by_realm[ realm ].setBit( k );
+        if (level <= kMaxSpellLevel)
+            m_spells_by_level[ level ].setBit( k );
+
+        if (data[0x149] == 0x01)
+            m_spells_by_school[ Alchemy ].setBit( k );
+        if (data[0x15b] == 0x01)
+            m_spells_by_school[ Wizardry ].setBit( k );
+        if (data[0x220] == 0x01)
+            m_spells_by_school[ Divinity ].setBit( k );
+        if (data[0x221] == 0x01)
+            m_spells_by_school[ Psionics ].setBit( k );
     }
-    return "";
 }
 
-QByteArray dbHelper::getItemRecord(quint32 item_id)
+const QBitArray &dbHelper::getSpellsInRealm(character::realm realm) const
+{
+    Q_ASSERT( (realm >= 0) && (realm < character::realm::REALM_SIZE) );
+
+    return m_spells_by_realm[ realm ];
+}
+
+const QBitArray &dbHelper::getSpellsAtLevel(int level) const
+{
+    Q_ASSERT( (level >= 0) && (level <= kMaxSpellLevel) );
+
+    return m_spells_by_level[ level ];
+}
+
+const QBitArray &dbHelper::getSpellsInSchool(school s) const
+{
+    Q_ASSERT( (s >= 0) && (s < SCHOOL_SIZE) );
+
+    return m_spells_by_school[ s ];
+}
+
+character::professions dbHelper::getSchoolProfessions(school s)
 {
-    if (m_item_db->seek(ITEM_START_OFFSET + item_id * ITEM_RECORD_SIZE))
+    switch (s)
     {
-        return m_item_db->read(ITEM_RECORD_SIZE);
+        case Alchemy:
+            return character::profession::Alchemist | character::profession::Ranger | character::profession::Ninja | character::profession::Bishop;
+
+        case Wizardry:
+            return character::profession::Mage | character::profession::Samurai | character::profession::Bishop;
+
+        case Divinity:
+            return character::profession::Priest | character::profession::Lord | character::profession::Valkyrie | character::profession::Bishop;
+
+        case Psionics:
+            return character::profession::Psionic | character::profession::Monk | character::profession::Bishop;
+
+        default:
+            break;
     }
-    return QByteArray();
+    return character::professions();
 }
 
-QString dbHelper::getSpellDesc(quint32 spell_id)
+// Every spell in any school taught to any of @profs
+QBitArray dbHelper::getSpellsForProfessions(character::professions profs) const
 {
-    qint32 spell_offset;
+    QBitArray spells( m_numSpells );
 
-    if (m_spelldesc_db->seek( m_spelldesc_idx_pos + spell_id * sizeof(qint32) ))
+    for (int k=0; k < SCHOOL_SIZE; k++)
     {
-        spell_offset = m_spelldesc_db->readLEULong();
-        if (m_spelldesc_db->seek( spell_offset ))
-        {
-            // Same as items, all spells seem to have the same byte sequence for the first 8 bytes:
-            // 01 00 00 00 00 ff ff ff
-            // No idea what they mean
+        if (profs & getSchoolProfessions( static_cast<school>(k) ))
+            spells |= m_spells_by_school[k];
+    }
+    return spells;
+}
+
+const monsterTable &dbHelper::getMonsterTable()
+{
+    static const monsterTable s_monsters = loadMonsterTable();
 
-            m_spelldesc_db->skip( 8 );
+    return s_monsters;
+}
 
-            // Next 4 bytes give the character length of the UTF-16LE text description that
-            // follows. Usually it is 0, but sometimes empty descriptions are indicated
-            // by 1 as well
-            qint32 str_len = m_spelldesc_db->readLEULong();
+// 0x00cd--0x00ce: NPC id
+monsterTable dbHelper::loadMonsterTable()
+{
+    monsterTable t;
 
-            QByteArray desc = m_spelldesc_db->read( str_len*2 );
+    t.numMonsters = 0;
+    t.db          = loadDb("DATABASES/MONSTERS.DBS");
 
-            return Localisation::decode( desc.constData(), str_len*2, true );
-        }
+    if (t.db.size() >= MONSTER_START_OFFSET)
+    {
+        // number of monsters in [0x0000--0x0003]
+        t.numMonsters = FORMAT_LE32((const quint8 *)t.db.constData());
+        t.numMonsters = qMin( t.numMonsters, (int)((t.db.size() - MONSTER_START_OFFSET) / MONSTER_RECORD_SIZE) );
+    }
+
+    for (int k=0; k < t.numMonsters; k++)
+    {
+        const quint8 *data = (const quint8 *)t.db.constData() + MONSTER_START_OFFSET + k * MONSTER_RECORD_SIZE;
+
+        // Where more than one monster claims an NPC, the last one wins
+        t.npcMonsters[ FORMAT_LE16(data + 0xcd) ] = k;
     }
-    return "";
+    return t;
 }
 
-QByteArray dbHelper::getSpellRecord(quint32 spell_id)
+// NULL for ids outside the database
+const quint8 *dbHelper::getMonsterRecord(quint32 monster_id) const
 {
-    if (m_spell_db->seek(m_spell_idx_pos + spell_id * SPELL_RECORD_SIZE))
+    const monsterTable &t = getMonsterTable();
+
+    if (monster_id < (quint32)t.numMonsters)
     {
-        return m_spell_db->read(SPELL_RECORD_SIZE);
+        return (const quint8 *)t.db.constData() + MONSTER_START_OFFSET + monster_id * MONSTER_RECORD_SIZE;
     }
-    return QByteArray();
+    return NULL;
+}
+
+// The monster id an NPC is placed in the levels as, or -1 if none
+int dbHelper::getMonsterForNpc(int npc_id) const
+{
+    return getMonsterTable().npcMonsters.value( npc_id, -1 );
 }
@@ -26,31 +26,110 @@
 #ifndef DBHELPER_H__
 #define DBHELPER_H__
 
-#include <QMutex>
+#include <QBitArray>
 #include <QByteArray>
+#include <QHash>
+#include <QVector>
 
 #include "character.h"
 #include "SLFFile.h"
 
-class dbHelper
+// The item fields that get filtered and sorted on, decoded once from the
+// item database into an array per field, all indexed by item id. Layout
+// and meaning of each field is as documented against its accessor in
+// item.cpp
+struct itemColumns
 {
-private:
-    static dbHelper *singleton;
-    static QMutex    alloc_lock;
+    QVector<quint8>    type;         // item::type
+    QVector<quint16>   weight;       // tenths of a pound
+    QVector<quint32>   price;
+    QVector<qint8>     ac;
+    QVector<quint16>   minDamage;
+    QVector<quint16>   maxDamage;
+    QVector<quint16>   professions;  // character::professions
+    QVector<quint16>   races;        // character::races
+    QVector<quint8>    genders;      // character::genders
+};
+
+// Bitsets over item id for every value of the enumerated item fields,
+// so filters on them are just ANDs and ORs of these. Flag fields get a
+// bitset per bit, everything else one per value. Only built the first
+// time something filters on them.
+struct itemBitsets
+{
+    QVector<QBitArray> professions;     // per bit of character::professions
+    QVector<QBitArray> races;           // per bit of character::races
+    QVector<QBitArray> genders;         // per bit of character::genders
+    QVector<QBitArray> specialAttacks;  // per bit of item::special_attacks
+
+    QVector<QBitArray> type;            // per item::type
+    QVector<QBitArray> stacking;
+
+    QBitArray          twoHanded;
+    QBitArray          secondary;
+    QBitArray          cursed;
+    QBitArray          hasSpell;
+};
 
-    SLFFile *m_item_db;
-    SLFFile *m_itemdesc_db;
-    qint64   m_itemdesc_idx_pos;
-    int      m_numItems;
+// MONSTERS.DBS and the index built over it. Only the NPC link is decoded
+// so far; names, levels and stats for the level and monster views still
+// need their record layout worked out. Only loaded the first time
+// something asks about monsters.
+struct monsterTable
+{
+    QByteArray         db;
+    int                numMonsters;
+    QHash<int, int>    npcMonsters;     // NPC id -> monster id
+};
+
+class dbHelper
+{
+public:
+    // The spell schools, each of which is flagged separately in the spell
+    // records and taught to its own set of professions
+    enum school
+    {
+        Alchemy,
+        Wizardry,
+        Divinity,
+        Psionics,
 
-    SLFFile *m_spell_db;
-    SLFFile *m_spelldesc_db;
-    qint64   m_spelldesc_idx_pos;
-    qint64   m_spell_idx_pos;
+        SCHOOL_SIZE
+    };
 
-    quint64 *m_quick_filter_items;
+    // Spell levels as used in the spell records, 0 being unused spells
+    static const int kMaxSpellLevel = 7;
 
-    void buildItemQuickFilter();
+private:
+    // The item and spell databases and their descriptions are all kept in
+    // memory - records handed out by getItemRecord() and getSpellRecord()
+    // point straight into these
+    QByteArray m_item_db;
+    QByteArray m_itemdesc_db;
+    qint64     m_itemdesc_idx_pos;
+    int        m_numItems;
+
+    QByteArray m_spell_db;
+    QByteArray m_spelldesc_db;
+    qint64     m_spelldesc_idx_pos;
+    int        m_numSpells;
+
+    itemColumns m_item_columns;
+
+    // Bitsets over spell id
+    QBitArray  m_spells_by_realm[character::realm::REALM_SIZE];
+    QBitArray  m_spells_by_level[kMaxSpellLevel + 1];
+    QBitArray  m_spells_by_school[SCHOOL_SIZE];
+
+    void buildItemColumns();
+    itemBitsets buildItemBitsets() const;
+    void buildSpellIndex();
+    static monsterTable loadMonsterTable();
+    static const monsterTable &getMonsterTable();
+
+    static QByteArray  loadDb(const QString &filename);
+    static qint64      descIndexPos(const QByteArray &db);
+    static QString     decodeDesc(const QByteArray &db, qint64 idx_pos, quint32 id);
 
 protected:
     dbHelper();
@@ -61,22 +140,39 @@ public:
     dbHelper(dbHelper &other) = delete;
     void operator=(const dbHelper &) = delete;
 
-    int                 getNumItems() { return m_numItems; }
+    // Everything from here on only reads data fixed at construction, so
+    // is safe to call from any thread without locking
+
+    int                 getNumItems() const { return m_numItems; }
 
-    QString             getItemDesc(quint32 item_id);
-    QByteArray          getItemRecord(quint32 item_id);
+    QString             getItemDesc(quint32 item_id) const;
+    const quint8       *getItemRecord(quint32 item_id) const;
+    const itemColumns  &getItemColumns() const { return m_item_columns; }
+    const itemBitsets  &getItemBitsets() const;
 
-    QString             getSpellDesc(quint32 item_id);
-    QByteArray          getSpellRecord(quint32 item_id);
+    int                 getNumSpells() const { return m_numSpells; }
 
-    QList<quint16>      getFilteredItems(character::profession p, character::race r, character::gender g);
+    QString             getSpellDesc(quint32 spell_id) const;
+    const quint8       *getSpellRecord(quint32 spell_id) const;
+
+    const QBitArray    &getSpellsInRealm(character::realm realm) const;
+    const QBitArray    &getSpellsAtLevel(int level) const;
+    const QBitArray    &getSpellsInSchool(school s) const;
+    QBitArray           getSpellsForProfessions(character::professions profs) const;
+
+    static character::professions getSchoolProfessions(school s);
+
+    int                 getNumMonsters() const { return getMonsterTable().numMonsters; }
+
+    const quint8       *getMonsterRecord(quint32 monster_id) const;
+    int                 getMonsterForNpc(int npc_id) const;
 
     static dbHelper *getHelper()
     {
-        alloc_lock.lock();
-        if (singleton == NULL)
-            singleton = new dbHelper();
-        alloc_lock.unlock();
+        // Initialisation of a function local static is thread safe, and
+        // after that this costs nothing
+        static dbHelper *singleton = new dbHelper();
+
         return singleton;
     }
 };
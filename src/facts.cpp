@@ -23,7 +23,8 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <QMapIterator>
+#include <QHashIterator>
+#include <QVector>
 
 #include "facts.h"
 #include "SLFFile.h"
@@ -32,84 +33,131 @@
 
 #define FACTDB_RECORD_SIZE    0x1d8
 
-facts::facts() : QObject(),
-    m_data(QByteArray())
+struct factNames
 {
-}
+    QVector<QString>    names;
+    QHash<QString, int> index;
+};
 
-// Character specific information is split into 2 separate areas.
-// A block of 0x1866 bytes and a block of 0x106 bytes
-// We keep an exact copy of the data passed into us because there
-// are a lot of fields we _don't_ parse and we'd like to preserve
-// those as far as possible on save.
-facts::facts(QByteArray f) : QObject(),
-    m_data(f)
+// The fact names only come from the game database, so they're read the
+// first time any facts object needs one and never change after that
+static const factNames &getFactNames()
 {
-    SLFFile fact_db("DATABASES/FACT.DBS");
-
-    if (fact_db.isGood())
+    static const factNames *s_names = []()
     {
-        fact_db.open( QIODevice::ReadOnly );
+        factNames *n = new factNames();
 
-        int named_facts_cnt = fact_db.readLEULong();
+        SLFFile fact_db("DATABASES/FACT.DBS");
 
-        fact_db.skip( 4 );
-
-        m_namedFacts.reserve( named_facts_cnt );
-        for (int k=0; k < named_facts_cnt; k++)
+        if (fact_db.isGood())
         {
-            QByteArray fact = fact_db.read( FACTDB_RECORD_SIZE );
+            fact_db.open( QIODevice::ReadOnly );
+
+            int named_facts_cnt = fact_db.readLEULong();
+
+            fact_db.skip( 4 );
+
+            n->names.reserve( named_facts_cnt );
+            n->index.reserve( named_facts_cnt );
+            for (int k=0; k < named_facts_cnt; k++)
+            {
+                QByteArray fact = fact_db.read( FACTDB_RECORD_SIZE );
+
+                // Fact is in ASCII, not unicode
+
+                n->names << QString::fromLatin1( fact );
+
+                // First one wins if a name is repeated, same as the old
+                // linear search did
+                if (! n->index.contains( n->names.last() ))
+                    n->index.insert( n->names.last(), k );
+            }
+            fact_db.close();
+        }
+        return n;
+    }();
 
-            // Fact is in ASCII, not unicode
+    return *s_names;
+}
+
+facts::facts() : QObject()
+{
+}
 
-            m_namedFacts << QString::fromLatin1( fact );
+// Facts are stored in the save as one byte each, which is always 0 or 1
+// in practice. We keep them as bits, but any other byte value is kept
+// as it was so the save is written back exactly as we found it.
+facts::facts(QByteArray f) : QObject(),
+    m_values(f.size())
+{
+    const quint8 *fdata = (const quint8 *) f.constData();
+
+    for (int k=0; k < f.size(); k++)
+    {
+        if (fdata[k] != 0x00)
+        {
+            m_values.setBit( k );
+
+            if (fdata[k] != 0x01)
+                m_otherValues.insert( k, fdata[k] );
         }
     }
 }
 
 facts::~facts()
 {
-    m_namedFacts.clear();
 }
 
 QByteArray facts::serialize() const
 {
-    return m_data;
+    if (m_values.isEmpty())
+        return QByteArray();
+
+    QByteArray f( m_values.size(), '\x00' );
+    quint8    *fdata = (quint8 *) f.data();
+
+    for (int k=0; k < m_values.size(); k++)
+    {
+        if (m_values.testBit( k ))
+            fdata[k] = 0x01;
+    }
+
+    QHashIterator<int, quint8> i( m_otherValues );
+    while (i.hasNext())
+    {
+        i.next();
+        fdata[ i.key() ] = i.value();
+    }
+    return f;
 }
 
 void facts::reset()
 {
-    m_data.fill( '\x00' );
+    m_values.fill( false );
+    m_otherValues.clear();
 }
 
 bool facts::isNull() const
 {
-    if (m_data.isNull() || (m_data.isEmpty()))
-    {
-        return true;
-    }
-    return false;
+    return m_values.isEmpty();
 }
 
 int facts::size() const
 {
-    if (m_data.isNull())
-    {
-        return 0;
-    }
-
-    return m_data.size();
+    return m_values.size();
 }
 
 QString facts::getKey( int idx ) const
 {
-    Q_ASSERT( idx < m_data.size() );
+    Q_ASSERT( idx < m_values.size() );
+
+    const factNames &n = getFactNames();
 
-    if (idx < m_namedFacts.size())
+    if (idx < n.names.size())
     {
-        return m_namedFacts[idx];
+        return n.names[idx];
     }
-    if (idx < m_data.size())
+    if (idx < m_values.size())
     {
         return QString("UNNAMED_FACT_%1").arg(idx);
     }
@@ -118,17 +166,11 @@ QString facts::getKey( int idx ) const
 
 bool facts::getValue( int idx ) const
 {
-    Q_ASSERT( idx < m_data.size() );
+    Q_ASSERT( idx < m_values.size() );
 
-    if (idx < m_data.size())
+    if ((idx >= 0) && (idx < m_values.size()))
     {
-        quint8 *fdata = (quint8 *) m_data.data();
-
-        if (fdata[idx] == 0x00)
-        {
-            return false;
-        }
-        return true;
+        return m_values.testBit( idx );
     }
     // can't return an error without changing prototype, which I don't
     // want to do, so assert above if the index is out of range. We
@@ -139,25 +181,21 @@ bool facts::getValue( int idx ) const
 
 void facts::setValue( int idx, bool value )
 {
-    Q_ASSERT( idx < m_data.size() );
+    Q_ASSERT( idx < m_values.size() );
 
-    if (idx < m_data.size())
+    if ((idx >= 0) && (idx < m_values.size()))
     {
-        quint8 *fdata = (quint8 *) m_data.data();
-
-        if (value == true)
-            fdata[idx] = 0x01;
-        else
-            fdata[idx] = 0x00;
+        m_values.setBit( idx, value );
+        m_otherValues.remove( idx );
     }
 }
 
-bool facts::testFact( QString fact_name )
+bool facts::testFact( const QString &fact_name ) const
 {
-    for (int k=0; k < m_namedFacts.size(); k++)
-    {
-        if (m_namedFacts[k].compare( fact_name ) == 0)
-            return getValue(k);
-    }
+    int idx = getFactNames().index.value( fact_name, -1 );
+
+    if (idx >= 0)
+        return getValue( idx );
+
     return false;
 }
@@ -26,8 +26,9 @@
 #ifndef FACTS_H__
 #define FACTS_H__
 
+#include <QBitArray>
 #include <QByteArray>
-#include <QList>
+#include <QHash>
 #include <QObject>
 #include <QString>
 
@@ -40,13 +41,13 @@ public:
     facts(QByteArray f);
     facts(const facts &other) : QObject()
     {
-        m_data       = other.m_data;
-        m_namedFacts = other.m_namedFacts;
+        m_values      = other.m_values;
+        m_otherValues = other.m_otherValues;
     }
     facts & operator=(const facts &other)
     {
-        m_data       = other.m_data;
-        m_namedFacts = other.m_namedFacts;
+        m_values      = other.m_values;
+        m_otherValues = other.m_otherValues;
 
         return *this;
     }
@@ -64,12 +65,16 @@ public:
     bool          getValue( int idx ) const;
     void          setValue( int idx, bool value );
 
-    bool          testFact( QString fact_name );
+    bool          testFact( const QString &fact_name ) const;
 
 private:
-    QByteArray        m_data;
+    // One bit per fact. The names are shared by every facts object, and
+    // live in facts.cpp
+    QBitArray           m_values;
 
-    QList<QString>    m_namedFacts;
+    // The odd fact that was neither 0 nor 1 in the save, kept so it can
+    // be written back unchanged unless it's explicitly set
+    QHash<int, quint8>  m_otherValues;
 };
 
 #endif
@@ -26,15 +26,16 @@
 #include <item.h>
 #include "main.h"
 
+#include <QBuffer>
 #include <QFile>
-#include <QTemporaryFile>
+#include <QHash>
 
 #include "character.h"
 #include "constants.h"
 #include "common.h"
 #include "spell.h"
+#include "ItemIconAtlas.h"
 #include "Localisation.h"
-#include "STI.h"
 
 #include <QDebug>
 
@@ -57,14 +58,8 @@ item::item(quint32 id, quint8 cnt, quint8 charges, quint8 identified, quint8 unc
 
     m_helper = dbHelper::getHelper();
 
-    if (m_id != 0xffffffff)
-    {
-        m_db_record = m_helper->getItemRecord(m_id);
-    }
-    else
-    {
-        m_db_record = NULL;
-    }
+    // Empty slots (0xffffffff) get the helper's all-zero record
+    m_db_record = m_helper->getItemRecord(m_id);
 }
 
 item::item(const quint8 *item_ptr, bool equipped) :
@@ -83,14 +78,8 @@ item::item(const quint8 *item_ptr, bool equipped) :
 
     m_helper = dbHelper::getHelper();
 
-    if (m_id != 0xffffffff)
-    {
-        m_db_record = m_helper->getItemRecord(m_id);
-    }
-    else
-    {
-        m_db_record = NULL;
-    }
+    // Empty slots (0xffffffff) get the helper's all-zero record
+    m_db_record = m_helper->getItemRecord(m_id);
 }
 
 // 0x0000: Item name
@@ -117,9 +106,11 @@ QString item::getDesc() const
 // 0x003e: Type of item
 item::type item::getType() const
 {
-    if (m_id != 0xffffffff)
+    // Ids past the end of the database get the helper's all-zero record,
+    // which would read back as type 0 rather than Other
+    if (m_id < (quint32)m_helper->getNumItems())
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         return (item::type)data[0x3e];
     }
@@ -135,7 +126,7 @@ QString item::getStiFile() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         int sti_idx = FORMAT_LE16(data+0x3f);
 
@@ -173,7 +164,7 @@ bool item::weaponRequiresStrength() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         int sti_idx = FORMAT_LE16(data+0x3f);
 
@@ -195,7 +186,7 @@ bool item::isOmnigun() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         int sti_idx = FORMAT_LE16(data+0x3f);
 
@@ -212,7 +203,7 @@ bool item::isOneShotMaximum() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         int sti_idx = FORMAT_LE16(data+0x3f);
 
@@ -229,7 +220,7 @@ bool item::damageComesFromAmmunition() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         int sti_idx = FORMAT_LE16(data+0x3f);
 
@@ -250,8 +241,8 @@ bool item::compatibleAmmunition( item ammo ) const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *ranged_data = (quint8 *)m_db_record.constData();
-        quint8 *ammo_data   = (quint8 *)ammo.m_db_record.constData();
+        const quint8 *ranged_data = m_db_record;
+        const quint8 *ammo_data   = ammo.m_db_record;
 
         int ranged_sti_idx = FORMAT_LE16(ranged_data+0x3f);
         int ammo_sti_idx   = FORMAT_LE16(ammo_data+0x3f);
@@ -363,7 +354,7 @@ bool item::compatibleAmmunition( item ammo ) const
 /*
 bool item::needsIdentify() const
 {
-    quint8 *data = (quint8 *)m_db_record.constData();
+    const quint8 *data = m_db_record;
 
     if (data[0x41] & 1) // DOESN'T need identify -- reversed flag
         return false;
@@ -371,7 +362,7 @@ bool item::needsIdentify() const
 }
 bool item::isCriticalItem() const
 {
-    quint8 *data = (quint8 *)m_db_record.constData();
+    const quint8 *data = m_db_record;
 
     if (data[0x41] & 2)
         return true;
@@ -382,7 +373,7 @@ bool item::needs2Hands() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         if (data[0x41] & 4)
             return true;
@@ -393,7 +384,7 @@ bool item::canSecondary() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         if (data[0x41] & 8)
             return true;
@@ -403,7 +394,7 @@ bool item::canSecondary() const
 /*
 bool item::isShopPersist() const
 {
-    quint8 *data = (quint8 *)m_db_record.constData();
+    const quint8 *data = m_db_record;
 
     if (data[0x41] & 16)
         return true;
@@ -411,7 +402,7 @@ bool item::isShopPersist() const
 }
 bool item::autoReplenishes() const
 {
-    quint8 *data = (quint8 *)m_db_record.constData();
+    const quint8 *data = m_db_record;
 
     if (data[0x41] & 128)
         return true;
@@ -424,7 +415,7 @@ item::spell_usage_type item::getSpellUsageType() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         return static_cast<item::spell_usage_type>(data[0x42]);
     }
@@ -440,7 +431,7 @@ character::skill item::getSkillUsed() const
 {
     if (m_id != 0xffffffff)
     {
-        qint8 *data = (qint8 *)m_db_record.constData();
+        const qint8 *data = (const qint8 *)m_db_record;
 
         return static_cast<character::skill> (data[0x46]);
     }
@@ -494,7 +485,7 @@ item::range item::getRange() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         return (item::range)data[0x47];
     }
@@ -511,7 +502,7 @@ int item::getInitiative() const
     if (m_id != 0xffffffff)
     {
         // Can be negative
-        qint8 *data = (qint8 *)m_db_record.constData();
+        const qint8 *data = (const qint8 *)m_db_record;
 
         return (data[0x48]);
     }
@@ -524,7 +515,7 @@ int item::getToHit() const
     if (m_id != 0xffffffff)
     {
         // Can be negative
-        qint8 *data = (qint8 *)m_db_record.constData();
+        const qint8 *data = (const qint8 *)m_db_record;
 
         return (data[0x49]);
     }
@@ -536,7 +527,7 @@ void item::getDamage(quint16 *min_damage, quint16 *max_damage, int *percentage)
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         quint16 c          = FORMAT_LE16(data+0x4a);
         quint8  num_dice   = data[0x4c];
@@ -574,7 +565,7 @@ item::attacks item::getAttacks() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         return (item::attacks)FORMAT_LE16(data+0x4e);
     }
@@ -620,7 +611,7 @@ item::special_attacks item::getSpecialAttack() const
 
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         if (data[0x50])
             list |= special_attack::Sleep;
@@ -661,7 +652,7 @@ int item::getPercentageChance(item::special_attack a) const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         QMetaEnum metaAttack = QMetaEnum::fromType<item::special_attack>();
 
@@ -677,7 +668,7 @@ int item::getPoisonStrength() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         return data[0x60];
     }
@@ -711,7 +702,7 @@ item::slays item::getSlays() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         return (item::slays) data[0x61];
     }
@@ -733,7 +724,7 @@ int item::getAC() const
     if (m_id != 0xffffffff)
     {
         // Can be negative
-        qint8 *data = (qint8 *)m_db_record.constData();
+        const qint8 *data = (const qint8 *)m_db_record;
 
         return data[0x62];
     }
@@ -746,7 +737,7 @@ const spell item::getSpell(int *power) const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         int spell_id = data[0x63];
 
@@ -768,7 +759,7 @@ bool item::isStackable() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         if (data[0x66] == 0x01)
             return true;
@@ -780,7 +771,7 @@ bool item::hasCharges() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         if (data[0x66] == 0x02)
             return true;
@@ -792,7 +783,7 @@ bool item::hasUses() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         if (data[0x66] == 0x03)
             return true;
@@ -804,7 +795,7 @@ bool item::hasShots() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         if (data[0x66] == 0x04)
             return true;
@@ -818,7 +809,7 @@ int item::getMaxCharges() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         quint16 c          = FORMAT_LE16(data+0x67);
         quint8  num_dice   = data[0x69];
@@ -839,7 +830,7 @@ quint8 item::getMaxStackSize() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         return data[0x6b];
     }
@@ -852,7 +843,7 @@ int item::getHPRegen() const
     if (m_id != 0xffffffff)
     {
         // Can be negative
-        qint8 *data = (qint8 *)m_db_record.constData();
+        const qint8 *data = (const qint8 *)m_db_record;
 
         return (int)data[0x6c];
     }
@@ -865,7 +856,7 @@ int item::getStaminaRegen() const
     if (m_id != 0xffffffff)
     {
         // Can be negative
-        qint8 *data = (qint8 *)m_db_record.constData();
+        const qint8 *data = (const qint8 *)m_db_record;
 
         return (int)data[0x6d];
     }
@@ -878,7 +869,7 @@ int item::getSPRegen() const
     if (m_id != 0xffffffff)
     {
         // Can be negative
-        qint8 *data = (qint8 *)m_db_record.constData();
+        const qint8 *data = (const qint8 *)m_db_record;
 
         return (int)data[0x6e];
     }
@@ -895,7 +886,7 @@ bool item::getResistance(int *fire, int *water, int *air, int *earth, int *menta
 {
     if (m_id != 0xffffffff)
     {
-        qint8 *data = (qint8 *)m_db_record.constData();
+        const qint8 *data = (const qint8 *)m_db_record;
 
         if ((data[0x6f] == 0) &&
             (data[0x70] == 0) &&
@@ -931,7 +922,7 @@ item::weight item::getArmorWeightClass() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         return (item::weight) data[0x75];
     }
@@ -953,7 +944,7 @@ character::professions item::getUsableProfessions() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         return (character::professions) FORMAT_LE16(data + 0x76);
     }
@@ -965,7 +956,7 @@ character::races item::getUsableRaces() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         return (character::races) FORMAT_LE16(data + 0x78);
     }
@@ -979,7 +970,7 @@ character::genders item::getUsableGenders() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         return (character::genders) data[0x7c];
     }
@@ -992,7 +983,7 @@ void item::getRequiredAttrib(int idx, character::attribute *attrib, qint32 *valu
 {
     if (m_id != 0xffffffff)
     {
-        qint8   *data = (qint8 *)m_db_record.constData();
+        const qint8 *data = (const qint8 *)m_db_record;
 
         *attrib = static_cast<character::attribute> (data[0x7d + 2 * idx]);
         *value  = (qint32)data[0x7e + 2 * idx];
@@ -1029,7 +1020,7 @@ void item::getRequiredSkill(int idx, character::skill *skill, qint32 *value) con
 {
     if (m_id != 0xffffffff)
     {
-        qint8   *data = (qint8 *)m_db_record.constData();
+        const qint8 *data = (const qint8 *)m_db_record;
 
         *skill = static_cast<character::skill> (data[0x81 + 2 * idx]);
         *value = (qint32)data[0x82 + 2 * idx];
@@ -1191,7 +1182,7 @@ void item::getIdentificationRequirement(int *artifacts, int *spell) const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         int id = (int)data[0x0085];
 
@@ -1217,7 +1208,7 @@ quint32 item::getPrice() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         return FORMAT_LE32(data+0x86);
     }
@@ -1229,7 +1220,7 @@ double item::getWeight() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         return (double)(FORMAT_LE16(data+0x8a)) / 10.0;
     }
@@ -1241,7 +1232,7 @@ bool item::isCursed() const
 {
     if (m_id != 0xffffffff)
     {
-        quint8 *data = (quint8 *)m_db_record.constData();
+        const quint8 *data = m_db_record;
 
         if (data[0x8c] == 1)
             return true;
@@ -1257,7 +1248,7 @@ int item::getBonusSwings() const
     if (m_id != 0xffffffff)
     {
         // Can be negative
-        qint8 *data = (qint8 *)m_db_record.constData();
+        const qint8 *data = (const qint8 *)m_db_record;
 
         return (int) data[0xad];
     }
@@ -1271,7 +1262,7 @@ character::skill item::getSkillBonus( int *bonus ) const
 {
     if (m_id != 0xffffffff)
     {
-        qint8 *data = (qint8 *)m_db_record.constData();
+        const qint8 *data = (const qint8 *)m_db_record;
 
         // Can be negative - we can't cast the data pointer above
         // because it interferes with the static cast below if it
@@ -1289,7 +1280,7 @@ character::attribute item::getAttributeBonus( int *bonus ) const
 {
     if (m_id != 0xffffffff)
     {
-        qint8 *data = (qint8 *)m_db_record.constData();
+        const qint8 *data = (const qint8 *)m_db_record;
 
         // Can be negative - we can't cast the data pointer above
         // because it interferes with the static cast below if it
@@ -1367,7 +1358,6 @@ void item::serializeOut(QDataStream &out) const
         << m_charges
         << m_identified
         << m_uncursed
-        << m_db_record
 
         // Warning: this field needs manual update
         // to set value appropriate for new location
@@ -1381,52 +1371,55 @@ void item::serializeIn(QDataStream &in)
         >> m_charges
         >> m_identified
         >> m_uncursed
-        >> m_db_record
 
         // Warning: this field needs manual update
         // to set value appropriate for new location
         >> m_equipped;
 
-    m_helper = dbHelper::getHelper();
+    // The record isn't streamed - it's just a view into the item database
+    m_helper    = dbHelper::getHelper();
+    m_db_record = m_helper->getItemRecord(m_id);
 }
 
-// FIXME: Fairly incomplete. Doesn't support tr() macro yet among other things
-QString item::getCompleteData(bool include_image) const
+// PNG encoding of the item's backpack icon, as embedded in the HTML used
+// for drag and drop. Encoding is done in memory, and only once per item
+// id, since dragging the same item around repeatedly is the normal case.
+// Pixmaps are GUI thread only, so this is too.
+QByteArray item::getIconPng() const
 {
-    QString html = "<html><body><table><tr>";
+    static QHash<quint32, QByteArray> s_png;
 
-    if (include_image)
-    {
-        QPixmap pix;
-        SLFFile imgs( "ITEMS/" + getStiFile().toUpper() );
+    QHash<quint32, QByteArray>::const_iterator it = s_png.constFind( m_id );
+    if (it != s_png.constEnd())
+        return it.value();
 
-        if (imgs.open(QFile::ReadOnly))
-        {
-            QByteArray array;
+    QPixmap pix = ItemIconAtlas::getAtlas()->getItemIcon( m_id, 0 );
 
-            imgs.readAll( array );
-            STI sti_imgs( array );
+    if (pix.isNull())
+    {
+        // The item lacks an image - some mods have this problem; use our
+        // generic replacement icon
+        pix = QPixmap( item::getMissingItemImage() );
+    }
 
-            pix = QPixmap::fromImage( sti_imgs.getImage( 0 ));
+    QByteArray png;
+    QBuffer    buffer( &png );
 
-            imgs.close();
-        }
-        else
-        {
-            // The item lacks an image - some mods have this problem; use our
-            // generic replacement icon
-            pix = QPixmap( item::getMissingItemImage() );
-        }
-        QTemporaryFile png;
-        png.setFileTemplate( png.fileTemplate() + ".png" );
+    buffer.open( QIODevice::WriteOnly );
+    pix.save( &buffer, "PNG" );
 
-        // have to open the file before we can get the filename
-        png.open();
-        pix.save( png.fileName() );
-        QByteArray pngData = png.readAll();
-        png.close();
+    s_png.insert( m_id, png );
+    return png;
+}
 
-        html += "<th><img src=\"data:image/png;base64, " + pngData.toBase64() + "\"/></th>";
+// FIXME: Fairly incomplete. Doesn't support tr() macro yet among other things
+QString item::getCompleteData(bool include_image) const
+{
+    QString html = "<html><body><table><tr>";
+
+    if (include_image)
+    {
+        html += "<th><img src=\"data:image/png;base64, " + getIconPng().toBase64() + "\"/></th>";
     }
     html += "<th>" + getName() + "</th></tr>";
 
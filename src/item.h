@@ -230,22 +230,22 @@ public:
 
     bool operator<(const item &other) const
     {
-        // Just sorting on object id doesn't give me the result
-        // Wizardry itself uses; the object groups aren't
-        // contiguously numbered
-
-        // So using the types as primary sort (will make it
-        // a little slower due to the object lookup)
-        int type_me   = static_cast<int> (getType());
-        int type_them = static_cast<int> (other.getType());
+        return getSortKey() < other.getSortKey();
+    }
 
-        if (type_me < type_them)
-            return true;
-        else if (type_me > type_them)
-            return false;
+    // Just sorting on object id doesn't give me the result
+    // Wizardry itself uses; the object groups aren't
+    // contiguously numbered
 
-        // And the id as a secondary sort
-        return m_id < other.m_id;
+    // So the type is the primary sort, taken from the column
+    // store rather than decoded from each record, then the id
+    // and then the count, all packed into one key that can be
+    // worked out once per item before a sort
+    quint64 getSortKey() const
+    {
+        return ((quint64)(quint8) getTypeFast() << 40) |
+               ((quint64) m_id                  <<  8) |
+                (quint64) m_cnt;
     }
     bool isNull() const
     {
@@ -342,6 +342,18 @@ public:
     quint8          getUnknown(int idx) const { return m_unknown[idx]; }
 
 private:
+    QByteArray      getIconPng() const;
+
+    // Same as getType() but from the helper's column store, for comparisons
+    item::type      getTypeFast() const
+    {
+        const itemColumns &c = m_helper->getItemColumns();
+
+        if (m_id < (quint32)c.type.size())
+            return static_cast<item::type>( c.type[ m_id ] );
+        return item::type::Other;
+    }
+
     quint32         m_id;
     quint8          m_cnt;
     quint8          m_charges;
@@ -349,7 +361,7 @@ private:
     quint8          m_uncursed;
     bool            m_equipped;
     quint8          m_unknown[4];
-    QByteArray      m_db_record;
+    const quint8   *m_db_record;      // view into dbHelper's in-memory ITEMS.DBS
 
     dbHelper     *m_helper;
 };
@@ -33,7 +33,6 @@
 #include <QFontDatabase>
 #include <QMessageBox>
 #include <QProcess>
-#include <QSettings>
 #include <QStringList>
 #include <QStyleFactory>
 #include <QTextCodec>
@@ -52,8 +51,10 @@
 #include "DialogBegin.h"
 #include "DialogPatchExe.h"
 #include "DialogParallelWorlds.h"
+#include "ItemIconAtlas.h"
 #include "Localisation.h"
 #include "MainWindow.h"
+#include "Settings.h"
 #include "main.h"
 #include "bspatch.h"
 #include "facts.h"
@@ -155,21 +156,21 @@ int makeFont(QString bitmapFont, QString otfFont, QString patchfile)
 
 void setupLanguageCode(bool reset)
 {
-    QSettings settings;
+    Settings *settings = Settings::getSettings();
 
-    QVariant codepage = settings.value( "Codepage" );
+    QVariant codepage = settings->value( "Codepage" );
 
     if (codepage.isNull() || reset)
     {
-        settings.setValue( "Codepage", "Windows-1251" );
+        settings->setValue( "Codepage", "Windows-1251" );
     }
 }
 
 bool setupWizardryPath(bool reset)
 {
-    QSettings settings;
+    Settings *settings = Settings::getSettings();
 
-    QVariant wpath = settings.value( "Wizardry Path" );
+    QVariant wpath = settings->value( "Wizardry Path" );
     QString  wizardry_path;
 
     if (! wpath.isNull() && !reset)
@@ -192,7 +193,7 @@ bool setupWizardryPath(bool reset)
 
                     if (it.fileName().compare( "Wiz8.exe", Qt::CaseInsensitive ) == 0)
                     {
-                        settings.setValue( "Wizardry Path", wizardry_path );
+                        settings->setValue( "Wizardry Path", wizardry_path );
                         SLFFile::setWizardryPath( wizardry_path );
                         return true;
                     }
@@ -711,6 +712,10 @@ int main(int argc, char *argv[])
 
     loc->setLocalisationActive( true );
 
+    // Start decoding (or loading the cached copy of) every item icon now, so
+    // the first inventory or item list that gets shown doesn't have to
+    ItemIconAtlas::getAtlas()->build();
+
 #ifndef USE_STANDARD_CURSORS
     SLFFile cursors( "CURSORS/2D-CURSORS.STI" );
     if (cursors.open(QFile::ReadOnly))
@@ -917,9 +922,46 @@ QString getSaveFileName(QWidget *parent, const QString &caption, const QString &
     return response;
 }
 
+QString getExistingDirectory(QWidget *parent, const QString &caption, const QString &directory)
+{
+    QString   response;
+    QStyle   *s = NULL;
+
+    QFileDialog dialog(parent, caption, directory);
+
+    dialog.setAcceptMode(QFileDialog::AcceptOpen);
+    dialog.setFileMode(QFileDialog::Directory);
+    dialog.setOption(QFileDialog::Option::ShowDirsOnly, true);
+    dialog.setOption(QFileDialog::Option::DontUseNativeDialog, true);
+    QStringList styleNames = QStyleFactory::keys();
+    for (const auto &style : styleNames)
+    {
+        s = QStyleFactory::create(style);
+
+        if (s)
+        {
+            dialog.setStyle( s );
+            break;
+        }
+    }
+
+    if (dialog.exec() == QDialog::Accepted)
+        response = dialog.selectedUrls().value(0).toLocalFile();
+
+    dialog.close();
+    dialog.setStyle( QApplication::style() );
+
+    if (s)
+    {
+        delete s;
+    }
+
+    return response;
+}
+
 facts s_facts = facts();
 
-void setFacts(facts f)
+void setFacts(const facts &f)
 {
     s_facts = f;
 }
@@ -944,19 +986,10 @@ bool testFact(QString fact_name)
 
 void  setBoolSetting(char *setting, bool value)
 {
-    QSettings settings;
-
-    settings.setValue(setting, value);
+    Settings::getSettings()->setValue(setting, value);
 }
 
 bool  getBoolSetting(char *setting)
 {
-    QSettings settings;
-
-    QVariant v = settings.value(setting);
-
-    if (v.isNull())
-        return false;
-
-    return v.toBool();
+    return Settings::getSettings()->getBool(setting);
 }
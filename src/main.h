@@ -41,7 +41,7 @@ const StringList     *getBaseStringTable();
 bool                  getIgnoreModStrings();
 void                  setIgnoreModStrings(bool value);
 
-void                  setFacts(facts f);
+void                  setFacts(const facts &f);
 bool                  testFact(int fact_id);
 bool                  testFact(QString fact_name);
 
@@ -55,3 +55,4 @@ bool                  isParallelWorlds();
 
 QString getOpenFileName(QWidget *parent, const QString &caption, const QString &directory, const QString &filter);
 QString getSaveFileName(QWidget *parent, const QString &caption, const QString &directory, const QString &filter);
+QString getExistingDirectory(QWidget *parent, const QString &caption, const QString &directory);
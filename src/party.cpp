@@ -28,6 +28,8 @@
 #include "item.h"
 
 #include <QDebug>
+#include <QPair>
+#include <QVector>
 #include "common.h"
 
 #include <algorithm>
@@ -763,11 +765,38 @@ double party::getLoad() const
     return weight;
 }
 
+// Sorts @items on item::getSortKey(), working each key out once up
+// front rather than twice per comparison. Items with the same key keep
+// the order they were in.
+static void sortOnKeys(QList<item> &items)
+{
+    QVector<QPair<quint64, int>> keys;
+
+    keys.reserve( items.size() );
+    for (int k=0; k < items.size(); k++)
+    {
+        keys << qMakePair( items.at(k).getSortKey(), k );
+    }
+
+    std::stable_sort( keys.begin(), keys.end(), [](const QPair<quint64, int> &l, const QPair<quint64, int> &r)
+    {
+        return l.first < r.first;
+    });
+
+    QList<item> sorted;
+
+    sorted.reserve( items.size() );
+    for (int k=0; k < keys.size(); k++)
+    {
+        sorted << items.at( keys[k].second );
+    }
+    items = sorted;
+}
+
 void party::sortItems()
 {
-    // This uses the custom operator '<' defined in the item
-    // class in order to work. That method uses the type of
-    // the item first, and then the id field to sort with.
+    // This sorts on the type of the item first, then the id
+    // field and the count (see item::getSortKey()).
     //
     // That is a much lazier approach than the actual game uses
     // but don't think it's important for an item editor.
@@ -778,7 +807,7 @@ void party::sortItems()
     //  4. price
     //  5. count
     //  6. charges
-    std::sort(m_items.begin(), m_items.end());
+    sortOnKeys( m_items );
 }
 
 void party::setVisitedMaps(QVector<qint32> maps)
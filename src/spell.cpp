@@ -35,15 +35,20 @@
 
 #include <QDebug>
 
+// Null spells still get something to read from, so that their accessors
+// are harmless
+static const quint8 s_empty_record[0x2c0] = { 0 };
+
 spell::spell(quint32 id) :
     m_id(id)
 {
     m_helper = dbHelper::getHelper();
 
     m_db_record = m_helper->getSpellRecord(m_id);
-    if (m_db_record.size() == 0)
+    if (m_db_record == NULL)
     {
-        m_id = 0xffffffff;
+        m_id        = 0xffffffff;
+        m_db_record = s_empty_record;
     }
 }
 
@@ -65,7 +70,7 @@ QString spell::getDesc() const
 // 0x014a--0x014d: Spell cost
 int spell::getSPCost() const
 {
-    quint8 *data = (quint8 *)m_db_record.constData();
+    const quint8 *data = m_db_record;
 
     return FORMAT_LE32(data+0x14a);
 }
@@ -73,16 +78,27 @@ int spell::getSPCost() const
 // 0x0157--0x015a: Spell level
 int spell::getLevel() const
 {
-    quint8 *data = (quint8 *)m_db_record.constData();
+    const quint8 *data = m_db_record;
 
     return FORMAT_LE32(data+0x157);
 }
 
 int spell::getLevelAsPureClass() const
+{
+    return pureClassLevel( getLevel() );
+}
+
+int spell::getLevelAsHybridClass() const
+{
+    return hybridClassLevel( getLevel() );
+}
+
+// Character level a pure magic user needs to cast spells of @spell_level
+int spell::pureClassLevel(int spell_level)
 {
     int class_level = 0;
 
-    switch (getLevel())
+    switch (spell_level)
     {
         case 1: class_level =  1; break;
         case 2: class_level =  3; break;
@@ -95,11 +111,13 @@ int spell::getLevelAsPureClass() const
     return class_level;
 }
 
-int spell::getLevelAsHybridClass() const
+// Character level a hybrid fighter and magic user needs to cast spells
+// of @spell_level
+int spell::hybridClassLevel(int spell_level)
 {
     int class_level = 0;
 
-    switch (getLevel())
+    switch (spell_level)
     {
         case 1: class_level =  5; break;
         case 2: class_level =  7; break;
@@ -115,7 +133,7 @@ int spell::getLevelAsHybridClass() const
 // 0x0152--0x0155: Spell damage
 void spell::getDamage(quint16 *min_damage, quint16 *max_damage) const
 {
-    quint8 *data = (quint8 *)m_db_record.constData();
+    const quint8 *data = m_db_record;
 
     if (FORMAT_LE32(data+0x248)) // spell that causes damage
     {
@@ -139,7 +157,7 @@ void spell::getDamage(quint16 *min_damage, quint16 *max_damage) const
 
 void spell::getDuration(qint32 *base, qint32 *per_pl) const
 {
-    quint8 *data = (quint8 *)m_db_record.constData();
+    const quint8 *data = m_db_record;
 
     qint32 const_duration = FORMAT_LE32(data+0x14e);
 
@@ -161,7 +179,7 @@ void spell::getDuration(qint32 *base, qint32 *per_pl) const
 // 0x0230--0x0233: Spell realm
 item::range spell::getRange() const
 {
-    quint8 *data = (quint8 *)m_db_record.constData();
+    const quint8 *data = m_db_record;
 
     return static_cast<item::range>(FORMAT_LE32(data+0x230));
 }
@@ -174,7 +192,7 @@ QString spell::getRangeString() const
 // 0x0234--0x0237: Spell realm
 character::realm spell::getRealm() const
 {
-    quint8 *data = (quint8 *)m_db_record.constData();
+    const quint8 *data = m_db_record;
 
     return static_cast<character::realm>(FORMAT_LE32(data+0x234));
 }
@@ -182,7 +200,7 @@ character::realm spell::getRealm() const
 // 0x0238--0x023b: Spell target
 spell::target spell::getTarget() const
 {
-    quint8 *data = (quint8 *)m_db_record.constData();
+    const quint8 *data = m_db_record;
 
     return static_cast<spell::target>(FORMAT_LE32(data+0x238));
 }
@@ -201,7 +219,7 @@ QString spell::getTargetString() const
 // 0x023c--0x023f: Spell usability
 spell::usable spell::getUsability() const
 {
-    quint8 *data = (quint8 *)m_db_record.constData();
+    const quint8 *data = m_db_record;
 
     return static_cast<spell::usable>(FORMAT_LE32(data+0x23c));
 }
@@ -230,26 +248,22 @@ QString spell::getUsabilityString() const
 // 0x015b: Mage
 // 0x0220: Priest
 // 0x0221: Psionic
+// These are held in the helper's per-school index rather than read again
 character::professions spell::getClasses() const
 {
     character::professions profs = {};
-    quint8 *data = (quint8 *)m_db_record.constData();
 
-    if (data[0x149] == 0x01)
-    {
-        profs |= character::profession::Alchemist | character::profession::Ranger | character::profession::Ninja | character::profession::Bishop;
-    }
-    if (data[0x15b] == 0x01)
-    {
-        profs |= character::profession::Mage | character::profession::Samurai | character::profession::Bishop;
-    }
-    if (data[0x220] == 0x01)
-    {
-        profs |= character::profession::Priest | character::profession::Lord | character::profession::Valkyrie | character::profession::Bishop;
-    }
-    if (data[0x221] == 0x01)
+    if (isNull())
+        return profs;
+
+    for (int k=0; k < dbHelper::SCHOOL_SIZE; k++)
     {
-        profs |= character::profession::Psionic | character::profession::Monk | character::profession::Bishop;
+        dbHelper::school s = static_cast<dbHelper::school>(k);
+
+        if (m_helper->getSpellsInSchool( s ).testBit( m_id ))
+        {
+            profs |= dbHelper::getSchoolProfessions( s );
+        }
     }
 
     return profs;
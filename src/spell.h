@@ -100,6 +100,9 @@ public:
     int                      getLevelAsPureClass() const;
     int                      getLevelAsHybridClass() const;
 
+    static int               pureClassLevel(int spell_level);
+    static int               hybridClassLevel(int spell_level);
+
     void                     getDuration(qint32 *base, qint32 *per_pl) const;
     void                     getDamage(quint16 *min_damage, quint16 *max_damage) const;
     item::range              getRange() const;
@@ -113,7 +116,7 @@ public:
 
 private:
     quint32         m_id;
-    QByteArray      m_db_record;
+    const quint8   *m_db_record;      // view into dbHelper's in-memory SPELLTABLES.DBS
 
     dbHelper     *m_helper;
 };